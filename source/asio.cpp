@@ -36,6 +36,18 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vector>
 #include <memory>
 #include <thread>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+#endif
 #include <asio.hpp>
 #include <asio/ssl.hpp>
 #include "asio.hpp"
@@ -50,6 +62,66 @@ vector_thread_ptr & ioThreads(){
   static vector_thread_ptr ptr;
   return(ptr);
 }
+//! Numer wątku uruchomionego przez ioRun() (-1 dla pozostałych wątków).
+static int & ioThreadIndex(){
+  static thread_local int i(-1);
+  return(i);
+}
+//! Zwraca numer ::asio::io_service przypisanego do wątku.
+static std::size_t ioThreadService(){
+  return((ioThreadIndex()<0)?0:ioThreadIndex());
+}
+//! Zwraca listę procesorów (CPU) dla wątku.
+static cpu_list_t ioThreadCpus(std::size_t i){
+  if (!ioConfig().cpus.empty()) return(ioConfig().cpus.at(i%ioConfig().cpus.size()));
+  if (!ioConfig().numa.empty()) return(ioNumaCpus(ioConfig().numa.at(i%ioConfig().numa.size())));
+  return(cpu_list_t());
+}
+//! Zwraca czas aktywnego oczekiwania dla wątku.
+static std::chrono::microseconds ioThreadSpin(){
+  if (ioConfig().spin.empty()||(ioThreadIndex()<0)) return(std::chrono::microseconds::zero());
+  return(ioConfig().spin.at(ioThreadIndex()%ioConfig().spin.size()));
+}
+error_code_t ioThreadPin(const cpu_list_t & cpus){
+  if (cpus.empty()) return(error_code_t());
+#ifdef __linux__
+  ::cpu_set_t set;
+  CPU_ZERO(&set);
+  for (const unsigned int & cpu : cpus) {
+    if (CPU_SETSIZE<=cpu) return(error_code_t(EINVAL,std::generic_category()));
+    CPU_SET(cpu,&set);
+  }
+  const int e(::pthread_setaffinity_np(::pthread_self(),sizeof(set),&set));
+  if (e) return(error_code_t(e,std::generic_category()));
+  return(error_code_t());
+#else
+  return(std::make_error_code(std::errc::not_supported));
+#endif
+}
+io_config_t & ioConfig(){
+  static io_config_t c;
+  return(c);
+}
+int ioWorker(){
+  return(ioThreadIndex());
+}
+cpu_list_t ioNumaCpus(unsigned int node){
+  cpu_list_t out;
+  std::ifstream f("/sys/devices/system/node/node"+std::to_string(node)+"/cpulist");
+  std::string list,range;
+  std::getline(f,list);
+  std::istringstream ranges(list);
+  while (std::getline(ranges,range,',')){
+    const std::size_t dash(range.find('-'));
+    try {
+      const unsigned int first(std::stoul(range.substr(0,dash)));
+      const unsigned int last((dash==std::string::npos)?first:std::stoul(range.substr(dash+1)));
+      for (unsigned int cpu=first;cpu<=last;cpu++) out.push_back(cpu);
+    } catch(...){
+    }
+  }
+  return(out);
+}
 void ioSignal(const signal_handler_t & handler){
   static ::asio::signal_set signals(ioService(),SIGINT,SIGTERM);
   signals.clear();
@@ -65,22 +137,55 @@ void ioSignal(const signal_handler_t & handler){
 }
 void ioSignal(){
   ioSignal([](const ::asio::error_code& error,int signal_number){
-    ioService().stop();
+    ioStop();
   });
 }
 void ioServiceRun(){
-  ioService().run();
+  ioServiceRun(ioThreadSpin());
 }
-void ioServicePost(const asio_handler_t &f){
-  ioService().post(f);
+void ioServiceRun(const std::chrono::microseconds & spin){
+  ::asio::io_service & io(ioService(ioThreadService()));
+  if (spin<=std::chrono::microseconds::zero()) {
+    io.run();
+    return;
+  }
+  while (!io.stopped()){
+    std::chrono::steady_clock::time_point deadline(std::chrono::steady_clock::now()+spin);
+    while (!io.stopped()){
+      if (io.poll()) {
+        deadline=std::chrono::steady_clock::now()+spin;
+      } else if (deadline<std::chrono::steady_clock::now()) {
+        break;
+      }
+    }
+    io.run_one();
+  }
+}
+void ioServicePost(asio_handler_t f){
+  ::asio::post(ioService(ioThreadService()),ioMonitorBind(std::move(f),ioThreadService()%ioServiceSize()));
+}
+void ioServicePost(priority_t priority,asio_handler_t f){
+  ioServicePost(ioService(ioThreadService()),priority,std::move(f));
 }
-void ioRun(const asio_handler_t &f){
-  static const unsigned int t(std::thread::hardware_concurrency());
+void ioServicePost(std::vector<asio_handler_t> handlers){
+  ioServicePost(ioService(ioThreadService()),std::move(handlers));
+}
+void ioRun(const thread_handler_t &f){
   if (!ioThreads()){
-    ioService().restart();
+    std::size_t n(ioServiceIsSingle()?ioServiceSize():ioConfig().threads);
+    if (!n) n=(1<ioServiceSize())?ioServiceSize():std::thread::hardware_concurrency();
+    if (!n) n=1;
+    for (std::size_t i=0;i<ioServiceSize();i++) ioService(i).restart();
     ioThreads().reset(new vector_thread_t);
-    for (;ioThreads()->size()<t;){
-      ioThreads()->emplace_back(f);
+    for (;ioThreads()->size()<n;){
+      const std::size_t i(ioThreads()->size());
+      const cpu_list_t cpus(ioThreadCpus(i));
+      ioThreads()->emplace_back([i,cpus,f](){
+        ioThreadIndex()=i;
+        const error_code_t ec(ioThreadPin(cpus));
+        if (ec) std::cerr<<__LINE__<<"|"<<"ict::asio::ioRun() - thread "<<i<<" not pinned|"<<ec<<"|"<<ec.message()<<std::endl;
+        f();
+      });
     }
   }
 }
@@ -94,18 +199,47 @@ void ioJoin(){
     ioThreads().reset(nullptr);
   }
 }
-void ioRunJoin(const asio_handler_t &f){
+void ioRunJoin(const thread_handler_t &f){
   ioRun(f);
   ioJoin();
 }
 void ioStop(){
-  ioService().stop();
+  for (std::size_t i=0;i<ioServiceSize();i++) ioService(i).stop();
+}
+const std::string & ioServiceBackend(){
+#if defined(ASIO_HAS_IO_URING_AS_DEFAULT)
+  static const std::string backend("io_uring");
+#elif defined(ASIO_HAS_IOCP)
+  static const std::string backend("iocp");
+#elif defined(ASIO_HAS_EPOLL)
+  static const std::string backend("epoll");
+#elif defined(ASIO_HAS_KQUEUE)
+  static const std::string backend("kqueue");
+#else
+  static const std::string backend("select");
+#endif
+  return(backend);
+}
+bool ioUringSupported(){
+#if defined(__linux__)&&defined(__NR_io_uring_setup)&&__has_include(<linux/io_uring.h>)
+  static const bool supported([](){
+    struct ::io_uring_params params={};
+    const long fd(::syscall(__NR_io_uring_setup,1,&params));
+    if (fd<0) return(false);
+    ::close(fd);
+    return(true);
+  }());
+  return(supported);
+#else
+  return(false);
+#endif
 }
 //============================================
 }}
 //============================================
 #ifdef ENABLE_TESTING
 #include "test.hpp"
+#include <atomic>
 REGISTER_TEST(asio,tc1){
   ict::asio::ioSignal();
   ict::asio::ioRun();
@@ -115,5 +249,82 @@ REGISTER_TEST(asio,tc1){
   ict::asio::ioJoin();
   return(0);
 }
+REGISTER_TEST(asio,tc2){
+  std::atomic<int> out(0);
+  const int n(4);
+  if (!ict::asio::ioServicePool(n,ict::asio::round_robin)) return(-1);
+  if (ict::asio::ioServiceSize()!=n) return(-2);
+  for (int i=0;i<n;i++) if (ict::asio::ioServiceIndex(ict::asio::ioServiceNext())!=i) return(-3);
+  ict::asio::ioSignal();
+  ict::asio::ioRun();
+  for (int i=0;i<n;i++) ict::asio::ioService(i).post([&out,n](){
+    if (++out==n) ict::asio::ioStop();
+  });
+  ict::asio::ioJoin();
+  if (out!=n) return(-4);
+  return(0);
+}
+REGISTER_TEST(asio,tc3){
+  std::atomic<int> out(0);
+  std::atomic<int> mask(0);
+  const int n(3);
+  ict::asio::ioConfig().threads=n;
+  ict::asio::ioConfig().cpus={{0}};
+  if (ict::asio::ioWorker()!=-1) return(-1);
+  ict::asio::ioSignal();
+  ict::asio::ioRun([&](){
+    mask|=(1<<ict::asio::ioWorker());
+    ict::asio::ioServiceRun();
+  });
+  for (int i=0;i<n;i++) ict::asio::ioServicePost([&out,n](){
+    if ((ict::asio::ioWorker()<0)||(n<=ict::asio::ioWorker())) out=-100;
+    if (++out==n) ict::asio::ioStop();
+  });
+  ict::asio::ioJoin();
+  if (mask!=((1<<n)-1)) return(-2);
+  if (out!=n) return(-3);
+  return(0);
+}
+static double test__roundtrip(const std::chrono::microseconds & spin){
+  const int n(1000);
+  std::atomic<int> out(0);
+  ict::asio::ioConfig().threads=1;
+  ict::asio::ioConfig().spin={spin};
+  ict::asio::ioRun();
+  const auto start(std::chrono::steady_clock::now());
+  for (int i=0;i<n;i++){
+    ict::asio::ioServicePost([&out](){
+      out++;
+    });
+    while (out<=i) std::this_thread::yield();
+    usleep(100);
+  }
+  const auto stop(std::chrono::steady_clock::now());
+  ict::asio::ioStop();
+  ict::asio::ioJoin();
+  ict::asio::ioConfig().threads=0;
+  ict::asio::ioConfig().spin.clear();
+  if (out!=n) return(-1);
+  return(std::chrono::duration<double,std::micro>(stop-start).count()/n-100);
+}
+REGISTER_TEST(asio,tc4){
+  const double sleep(test__roundtrip(std::chrono::microseconds::zero()));
+  const double spin(test__roundtrip(std::chrono::microseconds(1000)));
+  std::cout<<"run(): "<<sleep<<" us/op"<<std::endl;
+  std::cout<<"poll() + run_one(): "<<spin<<" us/op"<<std::endl;
+  if ((sleep<0)||(spin<0)) return(-1);
+  return(0);
+}
+REGISTER_TEST(asio,tc5){
+  int r(0);
+  //Przypisanie jest sprawdzane w osobnym wątku, aby nie zmieniać przypisania wątku testu.
+  std::thread([&r](){
+    if (ict::asio::ioThreadPin(ict::asio::cpu_list_t())) r=-1;
+    else if (ict::asio::ioThreadPin({(unsigned int)::sched_getcpu()})) r=-2;
+    else if (ict::asio::ioThreadPin({1u<<20}).value()!=EINVAL) r=-3;
+    else if (!ict::asio::ioThreadPin({CPU_SETSIZE-1})) r=-4;
+  }).join();
+  return(r);
+}
 #endif
 //===========================================
\ No newline at end of file
@@ -35,6 +35,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef _ASIO__HEADER
 #define _ASIO__HEADER
 //============================================
+#include <array>
+#include <vector>
+#include <chrono>
 #include "types.hpp"
 //============================================
 namespace ict { namespace asio {
@@ -43,24 +46,74 @@ namespace ict { namespace asio {
 //! @param ec Kod błędu
 //! @param signal Numer sygnału
 typedef std::function<void(const error_code_t&,int)> signal_handler_t;
+//! Funkcja wykonywana w każdym z wątków uruchamianych przez ioRun() (musi być kopiowalna).
+typedef std::function<void(void)> thread_handler_t;
+//! Lista procesorów (CPU).
+typedef std::vector<unsigned int> cpu_list_t;
+//! Konfiguracja wątków uruchamianych przez ioRun() (musi być ustawiona przed ioRun()).
+struct io_config_t {
+  //! Liczba wątków (0 - w trybie puli liczba ::asio::io_service, w przeciwnym razie std::thread::hardware_concurrency()).
+  unsigned int threads=0;
+  //! Procesory (CPU) dla kolejnych wątków - wątek i jest przypisany do cpus[i%cpus.size()] (pusta lista - bez przypisania).
+  std::vector<cpu_list_t> cpus;
+  //! Węzły NUMA dla kolejnych wątków - wątek i jest przypisany do procesorów węzła numa[i%numa.size()] (używane, gdy cpus jest puste).
+  std::vector<unsigned int> numa;
+  //! Czas aktywnego oczekiwania (::asio::io_service::poll()) dla kolejnych wątków - wątek i używa spin[i%spin.size()],
+  //! zanim zablokuje się w oczekiwaniu na zdarzenia (pusta lista lub zero - bez aktywnego oczekiwania).
+  std::vector<std::chrono::microseconds> spin;
+  //! Wartość opcji SO_BUSY_POLL (w us) dla gniazd TCP tworzonych przez konektory (zero - opcja nie jest ustawiana).
+  unsigned int busy_poll=0;
+  //! Wagi kolejek priorytetów (high_priority, normal_priority, bulk_priority) - w każdej rundzie z kolejki jest pobieranych
+  //! co najwyżej tyle zadań, ile wynosi jej waga (zanim zostaną pobrane zadania z kolejek o niższym priorytecie), patrz ioServicePost().
+  std::array<unsigned int,bulk_priority+1> weights={16,4,1};
+};
 //===========================================
+//! Dostęp do konfiguracji wątków uruchamianych przez ioRun().
+io_config_t & ioConfig();
+//! Zwraca numer wątku uruchomionego przez ioRun(), w którym wykonywany jest kod.
+//! @returns Numer wątku lub -1, gdy kod nie jest wykonywany w wątku uruchomionym przez ioRun().
+int ioWorker();
+//! Przypisuje bieżący wątek do procesorów (CPU) - wywoływana przez ioRun() dla wątków z ioConfig() (błąd jest wypisywany na std::cerr).
+//! @param cpus Lista procesorów (pusta - bez przypisania).
+//! @returns Kod błędu (np. EINVAL, gdy żaden z procesorów nie istnieje lub nie jest dostępny).
+error_code_t ioThreadPin(const cpu_list_t & cpus);
+//! Zwraca listę procesorów (CPU) węzła NUMA.
+//! @param node Numer węzła NUMA.
+//! @returns Lista procesorów (pusta, gdy węzeł nie istnieje).
+cpu_list_t ioNumaCpus(unsigned int node);
 //! Ustawienie obsługi sygnałów
 //! @param handler Funkcja do wykonania
 void ioSignal(const signal_handler_t & handler);
 //! Ustawienie obsługi sygnałów
 void ioSignal();
-// Uruchamia ::asio::io_service::run() w tym wątku.
+// Uruchamia ::asio::io_service::run() w tym wątku (w trybie puli - ::asio::io_service przypisany do wątku).
+// Jeśli dla wątku ustawiony jest czas aktywnego oczekiwania (patrz io_config_t::spin), używa ioServiceRun(spin).
 void ioServiceRun();
-// Uruchamia ::asio::io_service::post().
-void ioServicePost(const asio_handler_t &f);
-//! Uruchamia ::asio::io_service::run() w wielu osobnych wątkach
-void ioRun(const asio_handler_t &f=[]{ioServiceRun();});
+//! Uruchamia pętlę z aktywnym oczekiwaniem w tym wątku - wywołuje ::asio::io_service::poll() przez czas spin
+//! od ostatniego wykonanego zadania, a następnie blokuje się w ::asio::io_service::run_one().
+//! @param spin Czas aktywnego oczekiwania (zero - ::asio::io_service::run()).
+void ioServiceRun(const std::chrono::microseconds & spin);
+// Uruchamia ::asio::io_service::post() (w trybie puli - ::asio::io_service przypisany do wątku).
+void ioServicePost(asio_handler_t f);
+//! Dodaje zadanie do kolejki o podanym priorytecie (w trybie puli - ::asio::io_service przypisany do wątku).
+//! Zadania z kolejek priorytetów są wykonywane z wagami io_config_t::weights.
+void ioServicePost(priority_t priority,asio_handler_t f);
+//! Dodaje wiele zadań jedną operacją (w trybie puli - ::asio::io_service przypisany do wątku) - do ::asio::io_service trafia
+//! tyle zadań pomocniczych, ile wątków go obsługuje (nie więcej niż liczba zadań), a każde z nich wykonuje kolejne zadania z listy.
+//! @param handlers Lista zadań.
+void ioServicePost(std::vector<asio_handler_t> handlers);
+//! Uruchamia ::asio::io_service::run() w wielu osobnych wątkach (patrz ioConfig())
+void ioRun(const thread_handler_t &f=[]{ioServiceRun();});
 //! Oczekuje na zakończenie ::asio::io_service::run() w wielu osobnych wątkach
 void ioJoin();
 //! Uruchamia i oczekuje na zakończenie ::asio::io_service::run() w wielu osobnych wątkach
-void ioRunJoin(const asio_handler_t &f=[]{ioServiceRun();});
-//! Wykonuje ::asio::io_service::stop()
+void ioRunJoin(const thread_handler_t &f=[]{ioServiceRun();});
+//! Wykonuje ::asio::io_service::stop() (dla wszystkich ::asio::io_service w puli)
 void ioStop();
+//! Zwraca nazwę mechanizmu obsługi zdarzeń, z którym zbudowana jest biblioteka ("io_uring", "epoll", "kqueue", "iocp" lub "select").
+const std::string & ioServiceBackend();
+//! Sprawdza, czy jądro systemu obsługuje io_uring (niezależnie od tego, z jakim mechanizmem zbudowana jest biblioteka).
+bool ioUringSupported();
 //============================================
 }}
 //===========================================
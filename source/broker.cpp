@@ -73,8 +73,8 @@ private:
         return m;
     }
     static void post2(asio_handler_t handler){
-        static ::asio::io_service::strand strand(ioService());
-        strand.post(handler);
+        static strand_t strand(ioService());
+        strand.post(std::move(handler));
     }
     static void put(const ict::asio::connection::message_ptr & message,const std::string & key,const std::string & sni){
         post2([message,key,sni](){
@@ -95,13 +95,13 @@ private:
             }
         });     
     }
-    static void get(const broker_handler_t & handler,const std::string & key,const std::string & sni){
+    static void get(broker_handler_t handler,const std::string & key,const std::string & sni){
         pool2_t & p2(map()[key]);
         pool1_t & p1(p2.pool[sni]);
         p1.lastUsage=std::chrono::steady_clock::now();
         if (p1.connections.empty()){
             if (p2.connector){
-                p1.users.push(handler);
+                p1.users.push(std::move(handler));
                 p2.connector->async_connection([key,sni](const error_code_t& ec,const ict::asio::connection::message_ptr & message){
                     if (!ec){
                         implementation::put(message,key,sni);
@@ -191,25 +191,25 @@ public:
             put(message,key,connection->getSNI());
         }
     }
-    static void get(const broker_handler_t & handler,const std::string & host,const std::string & port,bool server,const ict::asio::context_ptr & context,const std::string & sni){
-        post2([handler,host,port,server,context,sni](){
+    static void get(broker_handler_t handler,const std::string & host,const std::string & port,bool server,const ict::asio::context_ptr & context,const std::string & sni){
+        post2([handler=std::move(handler),host,port,server,context,sni]() mutable {
             std::string k(host+_colon_+port+_colon_+(server?_server_:_client_));
             if (!map()[k].connector) map()[k].connector=ict::asio::connector::get(host,port,server,context,sni);
-            get(handler,k,sni);
+            get(std::move(handler),k,sni);
         });
     }
-    static void get(const broker_handler_t & handler,const std::string & path,bool server,const ict::asio::context_ptr & context,const std::string & sni){
-        post2([handler,path,server,context,sni](){
+    static void get(broker_handler_t handler,const std::string & path,bool server,const ict::asio::context_ptr & context,const std::string & sni){
+        post2([handler=std::move(handler),path,server,context,sni]() mutable {
             std::string k(path+_colon_+(server?_server_:_client_));
             if (!map()[k].connector) map()[k].connector=ict::asio::connector::get(path,server,context,sni);
-            get(handler,k,sni);
+            get(std::move(handler),k,sni);
         });
     }
     map_info_t & info(){
         auto self(interface::enable_shared_t::shared_from_this());
         static map_info_t bogus;
         if (connection){
-            return connection->info;
+            return connection->getInfoMap();
         }
         return bogus;
     }
@@ -245,10 +245,10 @@ public:
             connection->cancel(ec);
         }
     }
-    void post(const asio_handler_t &handler) override {
+    void post(asio_handler_t handler) override {
         auto self(interface::enable_shared_t::shared_from_this());
         if (connection){
-            connection->post(handler);
+            connection->post(std::move(handler));
         }
     }
     const std::string & getSNI() override {
@@ -258,20 +258,20 @@ public:
         }
         return _empty_;
     }
-    void async_write_body(const handler_t &handler) override {
+    void async_write_body(handler_t handler) override {
         auto self(interface::enable_shared_t::shared_from_this());
         if (connection){
-            connection->post([this,self,handler](){
+            connection->post([this,self,handler=std::move(handler)]() mutable {
                 switch (status){
                     case request_headers:
                         status=request_body;
                     case request_body:
-                        message->async_write_body(request.body,request.bytesLeft,handler);
+                        message->async_write_body(request.body,request.bytesLeft,std::move(handler));
                         break;
                     case response_headers:
                         status=response_body;
                     case response_body:
-                        message->async_write_body(response.body,response.bytesLeft,handler);
+                        message->async_write_body(response.body,response.bytesLeft,std::move(handler));
                         break;
                     default:{
                         error_code_t e(EBADE,std::generic_category());
@@ -284,20 +284,20 @@ public:
             handler(e);
         }
     }
-    void async_read_body(const handler_t &handler) override {
+    void async_read_body(handler_t handler) override {
         auto self(interface::enable_shared_t::shared_from_this());
         if (connection){
-            connection->post([this,self,handler](){
+            connection->post([this,self,handler=std::move(handler)]() mutable {
                 switch (status){
                     case request_headers:
                         status=request_body;
                     case request_body:
-                        message->async_read_body(request.body,request.bytesLeft,handler);
+                        message->async_read_body(request.body,request.bytesLeft,std::move(handler));
                         break;
                     case response_headers:
                         status=response_body;
                     case response_body:
-                        message->async_read_body(response.body,response.bytesLeft,handler);
+                        message->async_read_body(response.body,response.bytesLeft,std::move(handler));
                         break;
                     default:{
                         error_code_t e(EBADE,std::generic_category());
@@ -310,48 +310,48 @@ public:
             handler(e);
         }
     }
-    void async_write_request_headers(const handler_t &handler) override {
+    void async_write_request_headers(handler_t handler) override {
         auto self(interface::enable_shared_t::shared_from_this());
         if (connection){
-            connection->post([this,self,handler](){
+            connection->post([this,self,handler=std::move(handler)]() mutable {
                 status=request_headers;
-                message->async_write_request_headers(request.headers,handler);
+                message->async_write_request_headers(request.headers,std::move(handler));
             });
         } else {
             error_code_t e(ENOMEDIUM,std::generic_category());
             handler(e);
         }
     }
-    void async_read_request_headers(const handler_t &handler) override {
+    void async_read_request_headers(handler_t handler) override {
         auto self(interface::enable_shared_t::shared_from_this());
         if (connection){
-            connection->post([this,self,handler](){
+            connection->post([this,self,handler=std::move(handler)]() mutable {
                 status=request_headers;
-                message->async_read_request_headers(request.headers,handler);
+                message->async_read_request_headers(request.headers,std::move(handler));
             });
         } else {
             error_code_t e(ENOMEDIUM,std::generic_category());
             handler(e);
         }
     }
-    void async_write_response_headers(const handler_t &handler) override {
+    void async_write_response_headers(handler_t handler) override {
         auto self(interface::enable_shared_t::shared_from_this());
         if (connection){
-            connection->post([this,self,handler](){
+            connection->post([this,self,handler=std::move(handler)]() mutable {
                 status=response_headers;
-                message->async_write_response_headers(response.headers,handler);
+                message->async_write_response_headers(response.headers,std::move(handler));
             });
         } else {
             error_code_t e(ENOMEDIUM,std::generic_category());
             handler(e);
         }
     }
-    void async_read_response_headers(const handler_t &handler) override {
+    void async_read_response_headers(handler_t handler) override {
         auto self(interface::enable_shared_t::shared_from_this());
         if (connection){
-            connection->post([this,self,handler](){
+            connection->post([this,self,handler=std::move(handler)]() mutable {
                 status=response_headers;
-                message->async_read_response_headers(response.headers,handler);
+                message->async_read_response_headers(response.headers,std::move(handler));
             });
         } else {
             error_code_t e(ENOMEDIUM,std::generic_category());
@@ -360,11 +360,11 @@ public:
     }
 };
 //============================================
-void get(const broker_handler_t & handler,const std::string & host,const std::string & port,bool server,const ict::asio::context_ptr & context,const std::string & sni){
-    implementation::get(handler,host,port,server,context,sni);
+void get(broker_handler_t handler,const std::string & host,const std::string & port,bool server,const ict::asio::context_ptr & context,const std::string & sni){
+    implementation::get(std::move(handler),host,port,server,context,sni);
 }
-void get(const broker_handler_t & handler,const std::string & path,bool server,const ict::asio::context_ptr & context,const std::string & sni){
-    implementation::get(handler,path,server,context,sni);
+void get(broker_handler_t handler,const std::string & path,bool server,const ict::asio::context_ptr & context,const std::string & sni){
+    implementation::get(std::move(handler),path,server,context,sni);
 }
 //============================================
 //============================================
@@ -83,7 +83,7 @@ public:
     virtual void cancel(error_code_t& ec)=0;
     //! Dodaje zadanie do wykonania w ramach ::asio::strand
     //! @param handler Zadanie do wykonania.
-    virtual void post(const asio_handler_t &handler)=0;
+    virtual void post(asio_handler_t handler)=0;
     //! Zwraca nazwę serwera (SNI).
     //! @returns Nazwa serwera (SNI).
     virtual const std::string & getSNI()=0;
@@ -92,43 +92,43 @@ public:
     //! 
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu zapisu.
     //! 
-    virtual void async_write_body(const handler_t &handler)=0;
+    virtual void async_write_body(handler_t handler)=0;
     //! 
     //! @brief Odczytuje dane body wiadomości.
     //! 
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu odczytu.
     //! 
-    virtual void async_read_body(const handler_t &handler)=0;
+    virtual void async_read_body(handler_t handler)=0;
     //! 
     //! @brief Zapisuje wiersz zapytania oraz nagłówki.
     //! 
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu zapisu.
     //! 
-    virtual void async_write_request_headers(const handler_t &handler)=0;
+    virtual void async_write_request_headers(handler_t handler)=0;
     //! 
     //! @brief Odczytuje wiersz zapytania oraz nagłówki.
     //! 
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu odczytu.
     //! 
-    virtual void async_read_request_headers(const handler_t &handler)=0;
+    virtual void async_read_request_headers(handler_t handler)=0;
     //! 
     //! @brief Zapisuje wiersz odpowiedzi oraz nagłówki.
     //! 
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu zapisu.
     //! 
-    virtual void async_write_response_headers(const handler_t &handler)=0;
+    virtual void async_write_response_headers(handler_t handler)=0;
     //! 
     //! @brief Odczytuje wiersz odpowiedzi oraz nagłówki.
     //! 
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu odczytu.
     //! 
-    virtual void async_read_response_headers(const handler_t &handler)=0;
+    virtual void async_read_response_headers(handler_t handler)=0;
 };
 //===========================================
 //! Wskaźnik do interfejsu brokera.
 typedef std::shared_ptr<interface> interface_ptr;
 //! Handler zwracający brokera.
-typedef std::function<void(const error_code_t&,interface_ptr)> broker_handler_t;
+typedef unique_function<void(const error_code_t&,interface_ptr)> broker_handler_t;
 //===========================================
 //! Funkcja do połączeń TCP.
 //! @param host Host, na którym ma się bindować (jako serwer), lub do którego ma się łączyć (jako klient).
@@ -136,13 +136,13 @@ typedef std::function<void(const error_code_t&,interface_ptr)> broker_handler_t;
 //! @param server Informacja, czy to ma być połaczenie typu serwer, czy typu klient.
 //! @param context Informacja, czy połączenia mają być szyfrowane, czy nie (jeśli tak, to trzeba ustawić kontekst).
 //! @param sni Ustawnia SNI dla szyfrowanych połączeń wychodzących (klient) lub oczkuje podanego SNI (server).
-void get(const broker_handler_t & handler,const std::string & host,const std::string & port,bool server=true,const ict::asio::context_ptr & context=NULL,const std::string & sni="");
+void get(broker_handler_t handler,const std::string & host,const std::string & port,bool server=true,const ict::asio::context_ptr & context=NULL,const std::string & sni="");
 //! Funkcja połączeń lokalnych.
 //! @param path Ścieżka, na której ma się bindować (jako serwer), lub do której ma się łączyć (jako klient).
 //! @param server Informacja, czy to ma być  połaczenie typu serwer, czy typu klient.
 //! @param context Informacja, czy połączenia mają być szyfrowane, czy nie (jeśli tak, to trzeba ustawić kontekst).
 //! @param sni Ustawnia SNI dla szyfrowanych połączeń wychodzących (klient) lub oczkuje podanego SNI (server).
-void get(const broker_handler_t & handler,const std::string & path,bool server=true,const ict::asio::context_ptr & context=NULL,const std::string & sni="");
+void get(broker_handler_t handler,const std::string & path,bool server=true,const ict::asio::context_ptr & context=NULL,const std::string & sni="");
 //============================================
 }}}
 //===========================================
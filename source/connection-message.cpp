@@ -142,10 +142,10 @@ std::size_t getLineSize(const std::string & input){
     return(-1);
 }
 //============================================
-void message::async_write_request(ict::asio::message::request_t & request,const handler_t &handler){
+void message::async_write_request(ict::asio::message::request_t & request,handler_t handler){
     auto self(enable_shared_t::shared_from_this());
     if (connection){
-        connection->post([this,self,handler,&request](){
+        connection->post([this,self,handler=std::move(handler),&request]() mutable {
             if (!request.method.empty()){
                 std::size_t size=0;
                 size=getSpaceSize(request.method);
@@ -187,31 +187,31 @@ void message::async_write_request(ict::asio::message::request_t & request,const
                 minWrite=min;
             }
             if (minWrite<write.size()){
-                connection->async_write_string(write,[this,self,handler,&request](const ict::asio::error_code_t & ec){
+                connection->async_write_string(write,[this,self,handler=std::move(handler),&request](const ict::asio::error_code_t & ec) mutable {
                     if (ec){
                         handler(ec);
                     } else {
-                        async_write_request(request,handler);
+                        async_write_request(request,std::move(handler));
                     }
                 });   
             } else {
-                ioServicePost([self,handler](){
+                ioServicePost([self,handler=std::move(handler)](){
                     ict::asio::error_code_t ok;
                     handler(ok);
                 });
             }
         });
     } else {
-        ioServicePost([self,handler](){
+        ioServicePost([self,handler=std::move(handler)](){
             ict::asio::error_code_t ec(ENOTCONN,std::generic_category());
             handler(ec);
         });
     }
 }
-void message::async_read_request(ict::asio::message::request_t & request,const handler_t &handler){
+void message::async_read_request(ict::asio::message::request_t & request,handler_t handler){
     auto self(enable_shared_t::shared_from_this());
     if (connection){
-        connection->post([this,self,handler,&request](){
+        connection->post([this,self,handler=std::move(handler),&request]() mutable {
             std::size_t size=getLineSize(read);
             if (size!=-1){
                 std::string line(read.c_str(),size);
@@ -228,7 +228,7 @@ void message::async_read_request(ict::asio::message::request_t & request,const h
                     request.method.clear();
                 }
                 if (request.method.empty()){
-                    async_read_request(request,handler);
+                    async_read_request(request,std::move(handler));
                 } else {
                     size=getSpaceSize(line);
                     if (size!=-1){
@@ -252,37 +252,37 @@ void message::async_read_request(ict::asio::message::request_t & request,const h
                     } else {
                         request.version.clear();
                     }
-                    ioServicePost([self,handler](){
+                    ioServicePost([self,handler=std::move(handler)](){
                         ict::asio::error_code_t ok;
                         handler(ok);
                     });
                 }
             } else if (maxRead<read.size()){
-                ioServicePost([self,handler](){
+                ioServicePost([self,handler=std::move(handler)](){
                     ict::asio::error_code_t ec(EMSGSIZE,std::generic_category());
                     handler(ec);
                 });
             } else {
-                connection->async_read_string(read,[this,self,handler,&request](const ict::asio::error_code_t & ec){
+                connection->async_read_string(read,[this,self,handler=std::move(handler),&request](const ict::asio::error_code_t & ec) mutable {
                     if (ec){
                     handler(ec);
                     } else {
-                        async_read_request(request,handler);
+                        async_read_request(request,std::move(handler));
                     }
                 });
             }
         });
     } else {
-        ioServicePost([self,handler](){
+        ioServicePost([self,handler=std::move(handler)](){
             ict::asio::error_code_t ec(ENOTCONN,std::generic_category());
             handler(ec);
         });
     }
 }
-void message::async_write_response(ict::asio::message::response_t & response,const handler_t &handler){
+void message::async_write_response(ict::asio::message::response_t & response,handler_t handler){
     auto self(enable_shared_t::shared_from_this());
     if (connection){
-        connection->post([this,self,handler,&response](){
+        connection->post([this,self,handler=std::move(handler),&response]() mutable {
             if (!response.version.empty()){
                 std::size_t size=0;
                 size=getSpaceSize(response.version);
@@ -324,31 +324,31 @@ void message::async_write_response(ict::asio::message::response_t & response,con
                 minWrite=min;
             }
             if (minWrite<write.size()){
-                connection->async_write_string(write,[this,self,handler,&response](const ict::asio::error_code_t & ec){
+                connection->async_write_string(write,[this,self,handler=std::move(handler),&response](const ict::asio::error_code_t & ec) mutable {
                     if (ec){
                         handler(ec);
                     } else {
-                        async_write_response(response,handler);
+                        async_write_response(response,std::move(handler));
                     }
                 });   
             } else {
-                ioServicePost([self,handler](){
+                ioServicePost([self,handler=std::move(handler)](){
                     ict::asio::error_code_t ok;
                     handler(ok);
                 });
             }
         });
     } else {
-        ioServicePost([self,handler](){
+        ioServicePost([self,handler=std::move(handler)](){
             ict::asio::error_code_t ec(ENOTCONN,std::generic_category());
             handler(ec);
         });
     }
 }
-void message::async_read_response(ict::asio::message::response_t & response,const handler_t &handler){
+void message::async_read_response(ict::asio::message::response_t & response,handler_t handler){
     auto self(enable_shared_t::shared_from_this());
     if (connection){
-        connection->post([this,self,handler,&response](){
+        connection->post([this,self,handler=std::move(handler),&response]() mutable {
             std::size_t size=getLineSize(read);
             if (size!=-1){
                 std::string line(read.c_str(),size);
@@ -365,7 +365,7 @@ void message::async_read_response(ict::asio::message::response_t & response,cons
                     response.version.clear();
                 }
                 if (response.version.empty()){
-                    async_read_response(response,handler);
+                    async_read_response(response,std::move(handler));
                 } else {
                     size=getSpaceSize(line);
                     if (size!=-1){
@@ -389,37 +389,37 @@ void message::async_read_response(ict::asio::message::response_t & response,cons
                     } else {
                         response.explanation.clear();
                     }
-                    ioServicePost([self,handler](){
+                    ioServicePost([self,handler=std::move(handler)](){
                         ict::asio::error_code_t ok;
                         handler(ok);
                     });
                 }
             } else if (maxRead<read.size()){
-                ioServicePost([self,handler](){
+                ioServicePost([self,handler=std::move(handler)](){
                     ict::asio::error_code_t ec(EMSGSIZE,std::generic_category());
                     handler(ec);
                 });
             } else {
-                connection->async_read_string(read,[this,self,handler,&response](const ict::asio::error_code_t & ec){
+                connection->async_read_string(read,[this,self,handler=std::move(handler),&response](const ict::asio::error_code_t & ec) mutable {
                     if (ec){
                         handler(ec);
                     } else {
-                        async_read_response(response,handler);
+                        async_read_response(response,std::move(handler));
                     }
                 });
             }
         });
     } else {
-        ioServicePost([self,handler](){
+        ioServicePost([self,handler=std::move(handler)](){
             ict::asio::error_code_t ec(ENOTCONN,std::generic_category());
             handler(ec);
         });
     }
 }
-void message::async_write_header(ict::asio::message::header_t & header,const handler_t &handler){
+void message::async_write_header(ict::asio::message::header_t & header,handler_t handler){
     auto self(enable_shared_t::shared_from_this());
     if (connection){
-        connection->post([this,self,handler,&header](){
+        connection->post([this,self,handler=std::move(handler),&header]() mutable {
             if (!header.name.empty()){
                 std::size_t size=0;
                 size=getSpaceSize(header.name);
@@ -469,31 +469,31 @@ void message::async_write_header(ict::asio::message::header_t & header,const han
                 write.append(_ENDL_);
             }
             if (minWrite<write.size()){
-                connection->async_write_string(write,[this,self,handler,&header](const ict::asio::error_code_t & ec){
+                connection->async_write_string(write,[this,self,handler=std::move(handler),&header](const ict::asio::error_code_t & ec) mutable {
                     if (ec){
                         handler(ec);
                     } else {
-                        async_write_header(header,handler);
+                        async_write_header(header,std::move(handler));
                     }
                 });   
             } else {
-                ioServicePost([self,handler](){
+                ioServicePost([self,handler=std::move(handler)](){
                     ict::asio::error_code_t ok;
                     handler(ok);
                 });
             }
         });
     } else {
-        ioServicePost([self,handler](){
+        ioServicePost([self,handler=std::move(handler)](){
             ict::asio::error_code_t ec(ENOTCONN,std::generic_category());
             handler(ec);
         });
     }
 }
-void message::async_read_header(ict::asio::message::header_t & header,const handler_t &handler){
+void message::async_read_header(ict::asio::message::header_t & header,handler_t handler){
     auto self(enable_shared_t::shared_from_this());
     if (connection){
-        connection->post([this,self,handler,&header](){
+        connection->post([this,self,handler=std::move(handler),&header]() mutable {
             std::size_t size=getLineSize(read);
             if (size!=-1){
                 std::string line(read.c_str(),size);
@@ -531,90 +531,90 @@ void message::async_read_header(ict::asio::message::header_t & header,const hand
                         }
                     }
                 }
-                ioServicePost([self,handler](){
+                ioServicePost([self,handler=std::move(handler)](){
                     ict::asio::error_code_t ok;
                     handler(ok);
                 });
             } else if (maxRead<read.size()){
-                ioServicePost([self,handler](){
+                ioServicePost([self,handler=std::move(handler)](){
                     ict::asio::error_code_t ec(EMSGSIZE,std::generic_category());
                     handler(ec);
                 });
             } else {
-                connection->async_read_string(read,[this,self,handler,&header](const ict::asio::error_code_t & ec){
+                connection->async_read_string(read,[this,self,handler=std::move(handler),&header](const ict::asio::error_code_t & ec) mutable {
                     if (ec){
                         handler(ec);    
                     } else {
-                        async_read_header(header,handler);
+                        async_read_header(header,std::move(handler));
                     }
                 });
             }
         });
     } else {
-        ioServicePost([self,handler](){
+        ioServicePost([self,handler=std::move(handler)](){
             ict::asio::error_code_t ec(ENOTCONN,std::generic_category());
             handler(ec);
         });
     }
 }
-void message::async_write_body(const handler_t &handler){
+void message::async_write_body(handler_t handler){
     auto self(enable_shared_t::shared_from_this());
     if (connection){
         if (write.empty()){
             ict::asio::error_code_t ok;
             handler(ok);
         } else {
-            connection->async_write_string(write,[this,self,handler](const ict::asio::error_code_t & ec){
+            connection->async_write_string(write,[this,self,handler=std::move(handler)](const ict::asio::error_code_t & ec) mutable {
                 if (ec){
                     handler(ec);
                 } else {
-                    async_write_body(handler);
+                    async_write_body(std::move(handler));
                 }
             });
         }
     } else {
-        ioServicePost([self,handler](){
+        ioServicePost([self,handler=std::move(handler)](){
             ict::asio::error_code_t ec(ENOTCONN,std::generic_category());
             handler(ec);
         });
     }
 }
-void message::async_write_body(std::string & data,std::size_t & bytesLeft,const handler_t &handler){
+void message::async_write_body(std::string & data,std::size_t & bytesLeft,handler_t handler){
     auto self(enable_shared_t::shared_from_this());
     if (connection){
-        connection->post([this,self,handler,&data,&bytesLeft](){
+        connection->post([this,self,handler=std::move(handler),&data,&bytesLeft]() mutable {
             std::size_t size=(bytesLeft<data.size())?bytesLeft:data.size();
             bytesLeft-=size;
             write.append(data.c_str(),size);
             data.erase(0,size);
-            async_write_body(handler);
+            async_write_body(std::move(handler));
         });
     } else {
-        ioServicePost([self,handler](){
+        ioServicePost([self,handler=std::move(handler)](){
             ict::asio::error_code_t ec(ENOTCONN,std::generic_category());
             handler(ec);
         });
     }
 }
-void message::async_read_body(const handler_t &handler){
+void message::async_read_body(handler_t handler){
     auto self(enable_shared_t::shared_from_this());
     if (connection){
-        connection->async_read_string(read,[this,self,handler](const ict::asio::error_code_t & ec){
+        connection->async_read_string(read,[this,self,handler=std::move(handler)](const ict::asio::error_code_t & ec){
             handler(ec);
         });
     } else {
-        ioServicePost([self,handler](){
+        ioServicePost([self,handler=std::move(handler)](){
             ict::asio::error_code_t ec(ENOTCONN,std::generic_category());
             handler(ec);
         });
     }
 }
-void message::async_read_body(std::string & data,std::size_t & bytesLeft,const handler_t &handler){
+void message::async_read_body(std::string & data,std::size_t & bytesLeft,handler_t handler){
     auto self(enable_shared_t::shared_from_this());
     if (connection){
-        connection->post([this,self,handler,&data,&bytesLeft](){
+        connection->post([this,self,handler=std::move(handler),&data,&bytesLeft]() mutable {
             if (bytesLeft){
-                async_read_body([this,self,handler,&data,&bytesLeft](const ict::asio::error_code_t & ec){
+                async_read_body([this,self,handler=std::move(handler),&data,&bytesLeft](const ict::asio::error_code_t & ec){
                     if (ec){
                         handler(ec);
                     } else {
@@ -632,32 +632,32 @@ void message::async_read_body(std::string & data,std::size_t & bytesLeft,const h
             }
         });
     } else {
-        ioServicePost([self,handler](){
+        ioServicePost([self,handler=std::move(handler)](){
             ict::asio::error_code_t ec(ENOTCONN,std::generic_category());
             handler(ec);
         });
     }
 }
-void message::async_write_headers(ict::asio::message::headers_t & headers,const handler_t &handler){
+void message::async_write_headers(ict::asio::message::headers_t & headers,handler_t handler){
     auto self(enable_shared_t::shared_from_this());
     if (headers.empty()){
         ict::asio::error_code_t ok;
         handler(ok);
     } else {
-        async_write_header(headers[0],[this,self,&headers,handler](const ict::asio::error_code_t & ec){
+        async_write_header(headers[0],[this,self,&headers,handler=std::move(handler)](const ict::asio::error_code_t & ec) mutable {
             if (ec){
                 handler(ec);
             } else {
                 headers.erase(headers.begin());
-                async_write_headers(headers,handler);
+                async_write_headers(headers,std::move(handler));
             }
         });
     }
 }
-void message::async_read_headers(ict::asio::message::headers_t & headers,const handler_t &handler){
+void message::async_read_headers(ict::asio::message::headers_t & headers,handler_t handler){
     auto self(enable_shared_t::shared_from_this());
     headers.emplace_back();
-    async_read_header(headers[headers.size()-1],[this,self,&headers,handler](const ict::asio::error_code_t & ec){
+    async_read_header(headers[headers.size()-1],[this,self,&headers,handler=std::move(handler)](const ict::asio::error_code_t & ec) mutable {
         if (ec){
             handler(ec);
         } else {
@@ -665,54 +665,54 @@ void message::async_read_headers(ict::asio::message::headers_t & headers,const h
                 ict::asio::error_code_t ok;
                 handler(ok);
             } else {
-                async_read_headers(headers,handler);
+                async_read_headers(headers,std::move(handler));
             }
         }
     });
 }
-void message::async_write_request_headers(ict::asio::message::request_headers_t & request,const handler_t &handler){
+void message::async_write_request_headers(ict::asio::message::request_headers_t & request,handler_t handler){
     auto self(enable_shared_t::shared_from_this());
-    async_write_request(request.request,[this,self,&request,handler](const ict::asio::error_code_t & ec){
+    async_write_request(request.request,[this,self,&request,handler=std::move(handler)](const ict::asio::error_code_t & ec) mutable {
         if (ec){
             handler(ec);
         } else {
-            async_write_headers(request.headers,handler);
+            async_write_headers(request.headers,std::move(handler));
         }
     });
 }
-void message::async_read_request_headers(ict::asio::message::request_headers_t & request,const handler_t &handler){
+void message::async_read_request_headers(ict::asio::message::request_headers_t & request,handler_t handler){
     auto self(enable_shared_t::shared_from_this());
-    async_read_request(request.request,[this,self,&request,handler](const ict::asio::error_code_t & ec){
+    async_read_request(request.request,[this,self,&request,handler=std::move(handler)](const ict::asio::error_code_t & ec) mutable {
         if (ec){
             handler(ec);
         } else {
-            async_read_headers(request.headers,handler);
+            async_read_headers(request.headers,std::move(handler));
         }
     });
 }
-void message::async_write_response_headers(ict::asio::message::response_headers_t & response,const handler_t &handler){
+void message::async_write_response_headers(ict::asio::message::response_headers_t & response,handler_t handler){
     auto self(enable_shared_t::shared_from_this());
-    async_write_response(response.response,[this,self,&response,handler](const ict::asio::error_code_t & ec){
+    async_write_response(response.response,[this,self,&response,handler=std::move(handler)](const ict::asio::error_code_t & ec) mutable {
         if (ec){
             handler(ec);
         } else {
-            async_write_headers(response.headers,handler);
+            async_write_headers(response.headers,std::move(handler));
         }
     });
 }
-void message::async_read_response_headers(ict::asio::message::response_headers_t & response,const handler_t &handler){
+void message::async_read_response_headers(ict::asio::message::response_headers_t & response,handler_t handler){
     auto self(enable_shared_t::shared_from_this());
-    async_read_response(response.response,[this,self,&response,handler](const ict::asio::error_code_t & ec){
+    async_read_response(response.response,[this,self,&response,handler=std::move(handler)](const ict::asio::error_code_t & ec) mutable {
         if (ec){
             handler(ec);
         } else {
-            async_read_headers(response.headers,handler);
+            async_read_headers(response.headers,std::move(handler));
         }
     });
 }
-void message::post(const asio_handler_t &handler){
+void message::post(asio_handler_t handler){
   if (connection){
-    connection->post(handler);
+    connection->post(std::move(handler));
   }
 }
 message_ptr get(string_ptr iface){
@@ -64,13 +64,13 @@ private:
     //! 
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu zapisu.
     //! 
-    void async_write_body(const handler_t &handler);
+    void async_write_body(handler_t handler);
     //! 
     //! @brief Odczytuje body wiadomości.
     //! 
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu odczytu.
     //! 
-    void async_read_body(const handler_t &handler);
+    void async_read_body(handler_t handler);
 public:
     //! 
     //! @brief Konstruktor.
@@ -84,42 +84,42 @@ public:
     //! @param request Dane zapytania.
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu zapisu.
     //! 
-    void async_write_request(ict::asio::message::request_t & request,const handler_t &handler);
+    void async_write_request(ict::asio::message::request_t & request,handler_t handler);
     //! 
     //! @brief Odczytuje wiersz zapytania.
     //! 
     //! @param request Dane zapytania.
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu odczytu.
     //! 
-    void async_read_request(ict::asio::message::request_t & request,const handler_t &handler);
+    void async_read_request(ict::asio::message::request_t & request,handler_t handler);
     //! 
     //! @brief Zapisuje wiersz odpowiedzi.
     //! 
     //! @param response Dane odpowiedzi.
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu zapisu.
     //! 
-    void async_write_response(ict::asio::message::response_t & response,const handler_t &handler);
+    void async_write_response(ict::asio::message::response_t & response,handler_t handler);
     //! 
     //! @brief Odczytuje wiersz odpowiedzi.
     //! 
     //! @param response Dane odpowiedzi.
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu odczytu.
     //! 
-    void async_read_response(ict::asio::message::response_t & response,const handler_t &handler);
+    void async_read_response(ict::asio::message::response_t & response,handler_t handler);
     //! 
     //! @brief Zapisuje nagłówek.
     //! 
     //! @param header Dane nagłówka. Jeśli header.name jest ustawione na ":", to oznacza koniec nagłówków.
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu zapisu.
     //! 
-    void async_write_header(ict::asio::message::header_t & header,const handler_t &handler);
+    void async_write_header(ict::asio::message::header_t & header,handler_t handler);
     //! 
     //! @brief Odczytuje nagłówek.
     //! 
     //! @param header Dane nagłówka. Jeśli header.name jest ustawione na ":", to oznacza koniec nagłówków.
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu odczytu.
     //! 
-    void async_read_header(ict::asio::message::header_t & header,const handler_t &handler);
+    void async_read_header(ict::asio::message::header_t & header,handler_t handler);
     //! 
     //! @brief Zapisuje dane body wiadomości.
     //! 
@@ -127,7 +127,7 @@ public:
     //! @param bytesLeft Informacja ile bajtów body zostało do zapisania (aktualizowana).
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu zapisu.
     //! 
-    void async_write_body(std::string & data,std::size_t & bytesLeft,const handler_t &handler);
+    void async_write_body(std::string & data,std::size_t & bytesLeft,handler_t handler);
     //! 
     //! @brief Odczytuje dane body wiadomości.
     //! 
@@ -135,52 +135,52 @@ public:
     //! @param bytesLeft Informacja ile bajtów body zostało do odczytania (aktualizowana).
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu odczytu.
     //! 
-    void async_read_body(std::string & data,std::size_t & bytesLeft,const handler_t &handler);
+    void async_read_body(std::string & data,std::size_t & bytesLeft,handler_t handler);
     //! 
     //! @brief Zapisuje nagłówki.
     //! 
     //! @param headers Dane nagłówków. Jeśli header.name jest ustawione na ":", to oznacza koniec nagłówków (tak poiwnien być ustawiony ostatni).
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu zapisu.
     //! 
-    void async_write_headers(ict::asio::message::headers_t & headers,const handler_t &handler);
+    void async_write_headers(ict::asio::message::headers_t & headers,handler_t handler);
     //! 
     //! @brief Odczytuje nagłówki.
     //! 
     //! @param headers Dane nagłówków. Jeśli header.name jest ustawione na ":", to oznacza koniec nagłówków (tak będzie ustawiony ostatni).
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu odczytu.
     //! 
-    void async_read_headers(ict::asio::message::headers_t & headers,const handler_t &handler);
+    void async_read_headers(ict::asio::message::headers_t & headers,handler_t handler);
     //! 
     //! @brief Zapisuje wiersz zapytania oraz nagłówki.
     //! 
     //! @param request Dane zapytania oraz nagłówków. Jeśli header.name jest ustawione na ":", to oznacza koniec nagłówków (tak poiwnien być ustawiony ostatni).
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu zapisu.
     //! 
-    void async_write_request_headers(ict::asio::message::request_headers_t & request,const handler_t &handler);
+    void async_write_request_headers(ict::asio::message::request_headers_t & request,handler_t handler);
     //! 
     //! @brief Odczytuje wiersz zapytania oraz nagłówki.
     //! 
     //! @param request Dane zapytania oraz nagłówków. Jeśli header.name jest ustawione na ":", to oznacza koniec nagłówków (tak będzie ustawiony ostatni).
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu odczytu.
     //! 
-    void async_read_request_headers(ict::asio::message::request_headers_t & request,const handler_t &handler);
+    void async_read_request_headers(ict::asio::message::request_headers_t & request,handler_t handler);
     //! 
     //! @brief Zapisuje wiersz odpowiedzi oraz nagłówki.
     //! 
     //! @param request Dane odpowiedzi oraz nagłówków. Jeśli header.name jest ustawione na ":", to oznacza koniec nagłówków (tak poiwnien być ustawiony ostatni).
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu zapisu.
     //! 
-    void async_write_response_headers(ict::asio::message::response_headers_t & response,const handler_t &handler);
+    void async_write_response_headers(ict::asio::message::response_headers_t & response,handler_t handler);
     //! 
     //! @brief Odczytuje wiersz odpowiedzi oraz nagłówki.
     //! 
     //! @param request Dane odpowiedzi oraz nagłówków. Jeśli header.name jest ustawione na ":", to oznacza koniec nagłówków (tak będzie ustawiony ostatni).
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu odczytu.
     //! 
-    void async_read_response_headers(ict::asio::message::response_headers_t & response,const handler_t &handler);
+    void async_read_response_headers(ict::asio::message::response_headers_t & response,handler_t handler);
     //! Dodaje zadanie do wykonania w ramach ::asio::strand
     //! @param handler Zadanie do wykonania.
-    void post(const asio_handler_t &handler);
+    void post(asio_handler_t handler);
 };
 //===========================================
 //! Wskaźnik do interfejsu do obsługi połączeń.
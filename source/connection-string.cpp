@@ -40,58 +40,55 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 namespace ict { namespace asio { namespace connection {
 //============================================
 static const std::size_t max(0x10000);
-void string::async_write_string(std::string & buffer,const handler_t &handler){
+void string::async_write_string(std::string & buffer,handler_t handler){
     auto self(enable_shared_t::shared_from_this());
     if (buffer.empty()){
-        ioServicePost([self,handler](){
+        ioServicePost([self,handler=std::move(handler)](){
             ict::asio::error_code_t ec(ENODATA,std::generic_category());
             handler(ec);
         });
     } else if (connection){
-        connection->post([this,self,handler,&buffer](){
+        connection->post([this,self,handler=std::move(handler),&buffer]() mutable {
           std::size_t size=(max<buffer.size())?max:buffer.size();
-          write.resize(size);
-          buffer.copy((char*)write.data(),size,0);
-          connection->async_write_some(write,[this,self,handler,&buffer](const ict::asio::error_code_t& ec,std::size_t s){
-            write.clear();
+          connection->async_write_all(::asio::const_buffer(buffer.data(),size),[self=std::move(self),handler=std::move(handler),&buffer](const ict::asio::error_code_t& ec,std::size_t s){
             buffer.erase(0,s);
             handler(ec);
         });
       });
     } else {
-        ioServicePost([self,handler](){
+        ioServicePost([self,handler=std::move(handler)](){
             ict::asio::error_code_t ec(ENOTCONN,std::generic_category());
             handler(ec);
         });
     }
 }
-void string::async_read_string(std::string & buffer,const handler_t &handler){
+void string::async_read_string(std::string & buffer,handler_t handler){
     auto self(enable_shared_t::shared_from_this());
     if (buffer.max_size()<(buffer.size()+max)){
-        ioServicePost([self,handler](){
+        ioServicePost([self,handler=std::move(handler)](){
             ict::asio::error_code_t ec(ENOBUFS,std::generic_category());
             handler(ec);
         });
     } else if (connection){
-        connection->post([this,self,handler,&buffer](){
+        connection->post([this,self,handler=std::move(handler),&buffer]() mutable {
           std::size_t size=max;
           read.resize(size);
-          connection->async_read_some(read,[this,self,handler,&buffer](const ict::asio::error_code_t& ec,std::size_t s){
+          connection->async_read_some(read,[this,self=std::move(self),handler=std::move(handler),&buffer](const ict::asio::error_code_t& ec,std::size_t s){
             buffer.append((char*)read.data(),s);
             read.clear();
             handler(ec);
           });
         });
     } else {
-        ioServicePost([self,handler](){
+        ioServicePost([self,handler=std::move(handler)](){
             ict::asio::error_code_t ec(ENOTCONN,std::generic_category());
             handler(ec);
         });
     }
 }
-void string::post(const asio_handler_t &handler){
+void string::post(asio_handler_t handler){
   if (connection){
-    connection->post(handler);
+    connection->post(std::move(handler));
   }
 }
 string_ptr get(interface_ptr iface){
@@ -131,10 +128,10 @@ string2_ptr getString2(::asio::local::stream_protocol::socket & socket,context_p
     return getString2(get(get(socket,context,setSNI)));
 }
 //============================================
-void string2::async_write_string(const handler_t &handler){
+void string2::async_write_string(handler_t handler){
   auto self(enable_shared_t::shared_from_this());
   if (is_ok){
-    connection->async_write_string(write,[this,self,handler](const ict::asio::error_code_t& ec){
+    connection->async_write_string(write,[this,self,handler=std::move(handler)](const ict::asio::error_code_t& ec){
       handler(ec,write);
     });
   } else {
@@ -142,10 +139,10 @@ void string2::async_write_string(const handler_t &handler){
     handler(ec,write);
   }
 }
-void string2::async_read_string(const handler_t &handler){
+void string2::async_read_string(handler_t handler){
   auto self(enable_shared_t::shared_from_this());
   if (is_ok){
-    connection->async_read_string(read,[this,self,handler](const ict::asio::error_code_t& ec){
+    connection->async_read_string(read,[this,self,handler=std::move(handler)](const ict::asio::error_code_t& ec){
       handler(ec,read);
     });
   } else {
@@ -153,10 +150,10 @@ void string2::async_read_string(const handler_t &handler){
     handler(ec,read);
   }
 }
-void string2::post_write_string(const handler_t &handler){
+void string2::post_write_string(handler_t handler){
   auto self(enable_shared_t::shared_from_this());
   if (is_ok){
-    connection->connection->post([this,self,handler](){
+    connection->connection->post([this,self,handler=std::move(handler)](){
       static const ict::asio::error_code_t ec;
       handler(ec,write);
     });
@@ -165,10 +162,10 @@ void string2::post_write_string(const handler_t &handler){
     handler(ec,write);
   }
 }
-void string2::post_read_string(const handler_t &handler){
+void string2::post_read_string(handler_t handler){
   auto self(enable_shared_t::shared_from_this());
   if (is_ok){
-    connection->connection->post([this,self,handler](){
+    connection->connection->post([this,self,handler=std::move(handler)](){
       static const ict::asio::error_code_t ec;
       handler(ec,read);
     });
@@ -214,7 +211,7 @@ const std::string & string2::getSNI(){
 map_info_t & string2::getInfoMap(){
   static map_info_t empty;
   if (is_ok){
-    return connection->connection->info;
+    return connection->connection->getInfoMap();
   }
   return empty;
 }
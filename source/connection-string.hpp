@@ -44,13 +44,11 @@ class string : public std::enable_shared_from_this<string>{
 private:
     //! Bufor do odczytu danych.
     ict::asio::connection::interface::buffer_t read;
-    //! Bufor do zapisu danych.
-    ict::asio::connection::interface::buffer_t write;
 public:
     //! Typ pomocniczy do generowania wskaźnika.
     typedef  std::enable_shared_from_this<string> enable_shared_t;
-    //! Typ - Funkcja do obsługi zapisu lub odczytu.
-    typedef std::function<void(const ict::asio::error_code_t&)> handler_t;
+    //! Typ - Funkcja do obsługi zapisu lub odczytu (może być przenoszona, nie musi być kopiowalna).
+    typedef unique_function<void(const ict::asio::error_code_t&)> handler_t;
     //! Interfejs połączenia
     interface_ptr connection;
 public:
@@ -61,22 +59,22 @@ public:
     //! 
     string(const interface_ptr & i):connection(i){}
     //! 
-    //! @brief Funkcja do asynchronicznego zapisu.
+    //! @brief Funkcja do asynchronicznego zapisu (zapisuje w całości do 64 KiB danych z początku bufora - patrz interface::async_write_all()).
     //! 
     //! @param buffer Bufor zapisu.
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu zapisu.
     //! 
-    void async_write_string(std::string & buffer,const handler_t &handler);
+    void async_write_string(std::string & buffer,handler_t handler);
     //! 
     //! @brief Funkcja do asynchronicznego odczytu.
     //! 
     //! @param buffer Bufor odczytu.
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu odczytu.
     //! 
-    void async_read_string(std::string & buffer,const handler_t &handler);
+    void async_read_string(std::string & buffer,handler_t handler);
     //! Dodaje zadanie do wykonania w ramach ::asio::strand
     //! @param handler Zadanie do wykonania.
-    void post(const asio_handler_t &handler);
+    void post(asio_handler_t handler);
 };
 //===========================================
 //! Wskaźnik do interfejsu do obsługi połączeń.
@@ -98,8 +96,8 @@ private:
 public:
     //! Typ pomocniczy do generowania wskaźnika.
     typedef  std::enable_shared_from_this<string2> enable_shared_t;
-    //! Typ - Funkcja do obsługi zapisu lub odczytu.
-    typedef std::function<void(const ict::asio::error_code_t&,std::string&)> handler_t;
+    //! Typ - Funkcja do obsługi zapisu lub odczytu (może być przenoszona, nie musi być kopiowalna).
+    typedef unique_function<void(const ict::asio::error_code_t&,std::string&)> handler_t;
 public:
     //!
     //! @brief Konstruktor.
@@ -117,25 +115,25 @@ public:
     //! 
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu zapisu.
     //! 
-    void async_write_string(const handler_t &handler);
+    void async_write_string(handler_t handler);
     //! 
     //! @brief Funkcja do asynchronicznego odczytu.
     //! 
     //! @param handler Funkcja, która ma zostać wykonana po zakończeniu odczytu.
     //! 
-    void async_read_string(const handler_t &handler);
+    void async_read_string(handler_t handler);
         //! 
     //! @brief Funkcja do operacji na buforze zapisu.
     //! 
     //! @param handler Funkcja, która ma zostać wykonana.
     //! 
-    void post_write_string(const handler_t &handler);
+    void post_write_string(handler_t handler);
     //! 
     //! @brief Funkcja do operacji na buforze odczytu.
     //! 
     //! @param handler Funkcja, która ma zostać wykonana.
     //! 
-    void post_read_string(const handler_t &handler);
+    void post_read_string(handler_t handler);
     //! Funkcja zamyka połączenie.
     void close();
     //! Sprawdza, czy połaczenie jest nadal otwarte.
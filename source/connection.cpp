@@ -35,13 +35,24 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 **************************************************************/
 //============================================
 #include <vector>
+#include <deque>
+#include <atomic>
 #include <memory>
 #include <map>
+#include <mutex>
+#include <algorithm>
+#include <ctime>
+#include <unistd.h>
+#include <netinet/tcp.h>
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
 #include <asio.hpp>
 #include <asio/ssl.hpp>
 #include <asio/ssl/context.hpp>
 #include "service.h"
 #include "connection.h"
+#include "offload.hpp"
 //============================================
 namespace ict { namespace asio { namespace connection {
 //============================================
@@ -49,49 +60,477 @@ const static std::string _socket_type_("socket_type");
 const static std::string _socket_enc_("socket_enc");
 const static std::string _socket_local_("socket_local");
 const static std::string _socket_remote_("socket_remote");
+const static std::string _socket_resumed_("socket_resumed");
+const static std::string _socket_ktls_("socket_ktls");
 const static std::string _tcp_("tcp");
 const static std::string _local_("local");
 const static std::string _0_("0");
 const static std::string _1_("1");
 const static std::string _colon_(":");
 const static std::string _empty_("");
+//! Maksymalny rozmiar danych w rekordzie TLS.
+const static std::size_t _tls_record_(16384);
+//! Rozmiar bloku danych odczytywanego z pliku (patrz async_send_file()).
+const static std::size_t _file_chunk_(0x10000);
+//! Maksymalna liczba wiadomości z kolejki zapisu w jednym zapisie wektorowym.
+const static std::size_t _queue_gather_(64);
+//! Maksymalna liczba sesji TLS w pamięci podręcznej klienta.
+const static std::size_t _session_cache_size_(1024);
+//! Domyślny maksymalny czas zamykania połączenia SSL (wymiany close_notify, patrz interface::set_shutdown_timeout()).
+const static std::chrono::milliseconds _shutdown_timeout_(2000);
+//============================================
+//! Formatuje adres TCP (adres:port).
+static std::string endpointString(const ::asio::ip::tcp::endpoint & e){
+  return(e.address().to_string()+_colon_+std::to_string(e.port()));
+}
+//! Formatuje adres gniazda lokalnego (ścieżka).
+static std::string endpointString(const ::asio::local::stream_protocol::endpoint & e){
+  return(e.path());
+}
+//============================================
+//! Ustawia opcję gniazda, jeśli została podana (i nie wystąpił wcześniej błąd).
+template<int Level,int Name,class Socket,class Value> static void setOption(Socket & socket,const std::optional<Value> & value,error_code_t & ec){
+  if (value&&!ec) {
+    typedef ::asio::detail::socket_option::integer<Level,Name> option_t;
+    socket.set_option(option_t((int)*value),ec);
+  }
+}
+//! Zgłasza błąd, jeśli opcja nie jest obsługiwana w systemie.
+template<class Value> static void noOption(const std::optional<Value> & value,error_code_t & ec){
+  if (value&&!ec) ec=std::make_error_code(std::errc::not_supported);
+}
+//! Ustawia opcje gniazda wspólne dla wszystkich typów gniazd.
+template<class Socket> static void setSocketOptions(Socket & socket,const socket_options_t & options,error_code_t & ec){
+  setOption<SOL_SOCKET,SO_SNDBUF>(socket,options.send_buffer,ec);
+  setOption<SOL_SOCKET,SO_RCVBUF>(socket,options.receive_buffer,ec);
+}
+static void setSocketOptions(::asio::ip::tcp::socket::lowest_layer_type & socket,const socket_options_t & options,error_code_t & ec){
+  setSocketOptions<::asio::ip::tcp::socket::lowest_layer_type>(socket,options,ec);
+  setOption<IPPROTO_TCP,TCP_NODELAY>(socket,options.no_delay,ec);
+  setOption<SOL_SOCKET,SO_KEEPALIVE>(socket,options.keep_alive,ec);
+#ifdef TCP_QUICKACK
+  setOption<IPPROTO_TCP,TCP_QUICKACK>(socket,options.quick_ack,ec);
+#else
+  noOption(options.quick_ack,ec);
+#endif
+#ifdef TCP_NOTSENT_LOWAT
+  setOption<IPPROTO_TCP,TCP_NOTSENT_LOWAT>(socket,options.not_sent_low_watermark,ec);
+#else
+  noOption(options.not_sent_low_watermark,ec);
+#endif
+#ifdef SO_MAX_PACING_RATE
+  setOption<SOL_SOCKET,SO_MAX_PACING_RATE>(socket,options.max_pacing_rate,ec);
+#else
+  noOption(options.max_pacing_rate,ec);
+#endif
+#ifdef TCP_KEEPIDLE
+  setOption<IPPROTO_TCP,TCP_KEEPIDLE>(socket,options.keep_alive_idle,ec);
+  setOption<IPPROTO_TCP,TCP_KEEPINTVL>(socket,options.keep_alive_interval,ec);
+  setOption<IPPROTO_TCP,TCP_KEEPCNT>(socket,options.keep_alive_count,ec);
+#else
+  noOption(options.keep_alive_idle,ec);
+  noOption(options.keep_alive_interval,ec);
+  noOption(options.keep_alive_count,ec);
+#endif
+}
+static void setSocketOptions(::asio::local::stream_protocol::socket::lowest_layer_type & socket,const socket_options_t & options,error_code_t & ec){
+  setSocketOptions<::asio::local::stream_protocol::socket::lowest_layer_type>(socket,options,ec);
+}
 //============================================
-template <class Stream> class ifc : public interface{
+//! Połączenie obsługiwane przez post() dla wielu połączeń.
+class batch_ifc {
+public:
+  virtual ~batch_ifc(){}
+  //! Zwraca ::asio::io_service połączenia.
+  virtual ::asio::io_service & service()=0;
+  //! Wykonuje zadanie w ramach ::asio::strand połączenia (bez kolejkowania, jeśli to możliwe).
+  virtual void dispatch(asio_handler_t handler)=0;
+};
+template <class Stream> class ifc : public interface, public batch_ifc{
 protected:
   Stream stream;
-  ::asio::io_service::strand strand;
+  ict::asio::strand_t strand;
+  //! Bufor dla danych z pliku (patrz send_file_chunk()).
+  buffer_t file;
+  //! Wiadomość w kolejce zapisu.
+  struct queue_entry_t {
+    std::shared_ptr<const void> owner;
+    ::asio::const_buffer view;
+    handler_t handler;
+  };
+  //! Kolejka zapisu (patrz enqueue()).
+  std::deque<queue_entry_t> queue;
+  //! Ilość danych w kolejce zapisu.
+  std::atomic<std::size_t> queue_bytes{0};
+  //! Informacja, czy trwa zapis z kolejki.
+  bool writing=false;
+  //! Informacja, czy zgłoszono wstrzymanie (przekroczenie progu górnego).
+  bool paused=false;
+  //! Progi kolejki zapisu.
+  std::size_t low_watermark=0,high_watermark=0;
+  //! Funkcja wywoływana po przekroczeniu progów kolejki zapisu.
+  watermark_handler_t watermark;
+  //! Adres lokalny i zdalny (zapamiętane przy utworzeniu połączenia).
+  std::optional<typename Stream::lowest_layer_type::endpoint_type> local,remote;
+  //! Informacja, czy trwa uzgadnianie połączenia (operacje są wstrzymywane - patrz initiate()).
+  bool handshaking=false;
+  //! Błąd uzgadniania połączenia (kończą się nim wszystkie kolejne operacje).
+  error_code_t handshake_error;
+  //! Operacje wstrzymane do zakończenia uzgadniania połączenia.
+  std::vector<asio_handler_t> pending;
+  //! Maksymalny czas zamykania połączenia (patrz set_shutdown_timeout()).
+  std::chrono::milliseconds shutdown_timeout=_shutdown_timeout_;
 public:
-  ifc(Stream & s):stream(std::move(s)),strand(ict::asio::ioService()){}
-  template<class Socket> ifc(Socket & s,::asio::ssl::context & c):stream(std::move(s),c),strand(ict::asio::ioService()){}
-  void async_write_some(buffer_t& buffer,const handler_t &handler){
+  ifc(Stream & s):stream(std::move(s)),strand(ict::asio::ioServiceOf(stream.lowest_layer())){
+    ict::asio::ioServiceAttach(ict::asio::ioServiceOf(stream.lowest_layer()));
+    endpoints();
+  }
+  template<class Socket> ifc(Socket & s,::asio::ssl::context & c):stream(std::move(s),c),strand(ict::asio::ioServiceOf(stream.lowest_layer())){
+    ict::asio::ioServiceAttach(ict::asio::ioServiceOf(stream.lowest_layer()));
+    endpoints();
+  }
+  //! Zapamiętuje adres lokalny i zdalny połączenia (bez formatowania).
+  void endpoints(){
+    error_code_t ec;
+    auto l(stream.lowest_layer().local_endpoint(ec));
+    if (!ec) local=l;
+    ec.clear();
+    auto r(stream.lowest_layer().remote_endpoint(ec));
+    if (!ec) remote=r;
+  }
+  std::string getLocal() const {
+    return(local?endpointString(*local):_empty_);
+  }
+  std::string getRemote() const {
+    return(remote?endpointString(*remote):_empty_);
+  }
+  ~ifc(){
+    ict::asio::ioServiceDetach(ict::asio::ioServiceOf(stream.lowest_layer()));
+  }
+  void async_write_some(buffer_t& buffer,handler_t handler){
+    async_write_some(::asio::const_buffer(buffer.data(),buffer.size()),std::move(handler));
+  }
+  void async_read_some(buffer_t& buffer,handler_t handler){
+    async_read_some(::asio::mutable_buffer(buffer.data(),buffer.size()),std::move(handler));
+  }
+  void async_write_some(const ::asio::const_buffer & view,handler_t handler){
+    initiate(std::move(handler),[this,view](auto && h){
+      stream.async_write_some(view,std::move(h));
+    });
+  }
+  void async_read_some(const ::asio::mutable_buffer & view,handler_t handler){
+    initiate(std::move(handler),[this,view](auto && h){
+      stream.async_read_some(view,std::move(h));
+    });
+  }
+  void async_write_some(buffers_t& buffers,handler_t handler){
+    initiate(std::move(handler),[this,&buffers](auto && h){
+      std::vector<::asio::const_buffer> sequence;
+      sequence.reserve(buffers.size());
+      for (const buffer_t * buffer : buffers) if (buffer) sequence.emplace_back(buffer->data(),buffer->size());
+      stream.async_write_some(sequence,std::move(h));
+    });
+  }
+  void async_read_some(buffers_t& buffers,handler_t handler){
+    initiate(std::move(handler),[this,&buffers](auto && h){
+      std::vector<::asio::mutable_buffer> sequence;
+      sequence.reserve(buffers.size());
+      for (buffer_t * buffer : buffers) if (buffer) sequence.emplace_back(buffer->data(),buffer->size());
+      stream.async_read_some(sequence,std::move(h));
+    });
+  }
+  void async_write_all(buffer_t& buffer,handler_t handler){
+    async_write_all(::asio::const_buffer(buffer.data(),buffer.size()),std::move(handler));
+  }
+  void async_read_exact(buffer_t& buffer,handler_t handler){
+    async_read_exact(::asio::mutable_buffer(buffer.data(),buffer.size()),std::move(handler));
+  }
+  void async_write_all(const ::asio::const_buffer & view,handler_t handler){
+    initiate(std::move(handler),[this,view](auto && h){
+      ::asio::async_write(stream,view,std::move(h));
+    });
+  }
+  void async_read_exact(const ::asio::mutable_buffer & view,handler_t handler){
+    initiate(std::move(handler),[this,view](auto && h){
+      ::asio::async_read(stream,view,std::move(h));
+    });
+  }
+  void async_read_until(buffer_t& buffer,const std::string & delimiter,handler_t handler,std::size_t max){
+    initiate(std::move(handler),[this,&buffer,delimiter,max](auto && h){
+      ::asio::async_read_until(stream,::asio::dynamic_buffer(buffer,max),delimiter,std::move(h));
+    });
+  }
+  void async_send_file(int fd,std::size_t offset,std::size_t length,handler_t handler){
     auto self(interface::enable_shared_t::shared_from_this());
-    strand.post([self,this,&buffer,handler](){
-      stream.async_write_some(::asio::buffer(buffer.data(),buffer.size()),[self,this,handler](const ict::asio::error_code_t& ec,std::size_t s){
-        handler(ec,s);
+    strand.dispatch([self,this,fd,offset,length,handler=std::move(handler)]() mutable {
+      send_file_chunk(fd,offset,length,0,std::move(handler));
+    });
+  }
+  void enqueue(const std::shared_ptr<const void> & owner,const ::asio::const_buffer & view,handler_t handler){
+    auto self(interface::enable_shared_t::shared_from_this());
+    strand.dispatch([self,this,owner,view,handler=std::move(handler)]() mutable {
+      queue.push_back(queue_entry_t{std::move(owner),view,std::move(handler)});
+      queue_bytes+=view.size();
+      if (high_watermark&&(!paused)&&(high_watermark<=queue_bytes)){
+        paused=true;
+        if (watermark) watermark(true);
+      }
+      if (!(writing||handshaking)) drain();
+    });
+  }
+  void set_watermarks(std::size_t low,std::size_t high,const watermark_handler_t & handler){
+    auto self(interface::enable_shared_t::shared_from_this());
+    strand.dispatch([self,this,low,high,handler](){
+      low_watermark=low;
+      high_watermark=high;
+      watermark=handler;
+    });
+  }
+  std::size_t queued() const {
+    return(queue_bytes);
+  }
+  void async_handshake(bool server,const std::string & session,const std::chrono::milliseconds & timeout,error_handler_t handler){
+    strand.post([handler=std::move(handler)]() mutable {
+      handler(error_code_t());
+    });
+  }
+protected:
+  //! Uruchamia operację w ramach ::asio::strand (od razu, jeśli wątek już wykonuje zadanie tego ::asio::strand),
+  //! a funkcję do obsługi zapisu lub odczytu przypisuje do ::asio::strand (patrz strand_t::bind()).
+  //! @param handler Funkcja do obsługi zapisu lub odczytu.
+  //! @param start Funkcja uruchamiająca operację ASIO - otrzymuje funkcję zakończenia operacji.
+  //! W trakcie uzgadniania połączenia operacja jest uruchamiana po jego zakończeniu (patrz handshaked()).
+  template<class Start> void initiate(handler_t && handler,Start && start){
+    auto self(interface::enable_shared_t::shared_from_this());
+    strand.dispatch([self,this,handler=std::move(handler),start=std::forward<Start>(start)]() mutable {
+      if (handshaking){
+        pending.emplace_back([self=std::move(self),this,handler=std::move(handler),start=std::move(start)]() mutable {
+          begin(std::move(self),std::move(handler),start);
+        });
+      } else {
+        begin(std::move(self),std::move(handler),start);
+      }
+    });
+  }
+  //! Uruchamia operację (w ramach ::asio::strand) - po nieudanym uzgodnieniu połączenia kończy ją błędem uzgadniania.
+  template<class Start> void begin(interface_ptr && self,handler_t && handler,Start & start){
+    if (handshake_error){
+      complete(std::move(handler),handshake_error,0);
+      return;
+    }
+    strand.bind([self=std::move(self),this,handler=std::move(handler)](const ict::asio::error_code_t& ec,std::size_t s) mutable {
+      complete(std::move(handler),ec,s);
+    },start);
+  }
+  //! Kończy uzgadnianie połączenia (w ramach ::asio::strand) i uruchamia wstrzymane operacje.
+  //! @param ec Kod błędu uzgadniania połączenia.
+  void handshaked(const error_code_t & ec){
+    handshaking=false;
+    handshake_error=ec;
+    std::vector<asio_handler_t> p(std::move(pending));
+    pending.clear();
+    for (asio_handler_t & h : p) h();
+    if (!writing) drain();
+  }
+  //! Zapisuje wiadomości z początku kolejki zapisu (jednym zapisem wektorowym).
+  void drain(){
+    if (queue.empty()){
+      writing=false;
+      return;
+    }
+    if (handshake_error){
+      drained(handshake_error,queue.size());
+      return;
+    }
+    writing=true;
+    write_queue();
+  }
+  //! Uruchamia zapis wiadomości z początku kolejki zapisu (niepusta) - po jego zakończeniu wywołuje drained().
+  virtual void write_queue(){
+    const std::size_t count(std::min(queue.size(),_queue_gather_));
+    std::vector<::asio::const_buffer> sequence;
+    sequence.reserve(count);
+    for (std::size_t k=0;k<count;k++) sequence.push_back(queue[k].view);
+    auto self(interface::enable_shared_t::shared_from_this());
+    strand.bind([self,this,count](const ict::asio::error_code_t& ec,std::size_t s){
+      drained(ec,count);
+    },[this,sequence=std::move(sequence)](auto && h){
+      ::asio::async_write(stream,sequence,std::move(h));
+    });
+  }
+  //! Kończy zapis wiadomości z kolejki zapisu (w przypadku błędu - wszystkie wiadomości z kolejki kończą się tym błędem).
+  //! @param ec Kod błędu.
+  //! @param count Liczba zapisanych wiadomości.
+  void drained(const ict::asio::error_code_t& ec,std::size_t count){
+    if (ec) count=queue.size();
+    for (std::size_t k=0;k<count;k++){
+      queue_entry_t e(std::move(queue.front()));
+      queue.pop_front();
+      queue_bytes-=e.view.size();
+      if (e.handler) complete(std::move(e.handler),ec,ec?0:e.view.size());
+    }
+    if (paused&&(queue_bytes<=low_watermark)){
+      paused=false;
+      if (watermark) watermark(false);
+    }
+    drain();
+  }
+  //! Wysyła kolejny blok danych z pliku przez bufor (dla strumieni, które nie mogą użyć sendfile()).
+  //! Odczyt z pliku (pread()) jest wykonywany w puli wątków do zadań obliczeniowych (patrz ioServiceOffload()) - nie blokuje wątku ::asio::io_service.
+  //! @param fd Deskryptor pliku.
+  //! @param offset Pozycja w pliku.
+  //! @param left Ilość danych pozostałych do wysłania.
+  //! @param sent Ilość wysłanych danych.
+  //! @param handler Funkcja do obsługi zapisu.
+  void send_file_chunk(int fd,std::size_t offset,std::size_t left,std::size_t sent,handler_t && handler){
+    if (!left) {
+      complete(std::move(handler),error_code_t(),sent);
+      return;
+    }
+    file.resize(std::min(left,_file_chunk_));
+    auto self(interface::enable_shared_t::shared_from_this());
+    //Wynik pread() i errno.
+    std::shared_ptr<std::pair<ssize_t,int>> result(std::make_shared<std::pair<ssize_t,int>>(0,0));
+    ioServiceOffload(self,[this,fd,offset,result](){
+      result->first=::pread(fd,file.data(),file.size(),offset);
+      result->second=errno;
+    },[self,this,fd,offset,left,sent,result,handler=std::move(handler)](const ict::asio::error_code_t& e) mutable {
+      const ssize_t n(result->first);
+      if (e||(n<=0)) {
+        complete(std::move(handler),e?e:((n<0)?error_code_t(result->second,std::generic_category()):error_code_t(::asio::error::eof)),sent);
+        return;
+      }
+      async_write_all(::asio::const_buffer(file.data(),n),[self,this,fd,offset,left,sent,handler=std::move(handler)](const ict::asio::error_code_t& ec,std::size_t s) mutable {
+        if (ec) {
+          complete(std::move(handler),ec,sent+s);
+        } else {
+          send_file_chunk(fd,offset+s,left-s,sent+s,std::move(handler));
+        }
       });
     });
   }
-  void async_read_some(buffer_t& buffer,const handler_t &handler){
+#ifdef __linux__
+  //! Wysyła dane z pliku funkcją sendfile() bezpośrednio do gniazda (bez szyfrowania).
+  //! @param fd Deskryptor pliku.
+  //! @param offset Pozycja w pliku.
+  //! @param length Ilość danych do wysłania.
+  //! @param handler Funkcja do obsługi zapisu.
+  //! Tryb nieblokujący gniazda jest włączany na czas operacji i przywracany przed wywołaniem funkcji do obsługi zapisu.
+  void async_send_file_direct(int fd,std::size_t offset,std::size_t length,handler_t && handler){
     auto self(interface::enable_shared_t::shared_from_this());
-    strand.post([self,this,&buffer,handler](){
-      stream.async_read_some(::asio::buffer(buffer.data(),buffer.size()),[self,this,handler](const ict::asio::error_code_t& ec,std::size_t s){
+    strand.dispatch([self,this,fd,offset,length,handler=std::move(handler)]() mutable {
+      error_code_t ec;
+      const bool mode(stream.lowest_layer().non_blocking());
+      stream.lowest_layer().non_blocking(true,ec);
+      if (ec) {
+        complete(std::move(handler),ec,0);
+      } else {
+        send_file_direct(fd,offset,length,0,[self,this,mode,handler=std::move(handler)](const ict::asio::error_code_t& ec,std::size_t s) mutable {
+          error_code_t e;
+          stream.lowest_layer().non_blocking(mode,e);
+          handler(ec,s);
+        });
+      }
+    });
+  }
+  //! Wysyła dane z pliku, dopóki gniazdo przyjmuje dane - po zapełnieniu bufora gniazda czeka (w ramach ::asio::strand) na możliwość zapisu.
+  //! @param fd Deskryptor pliku.
+  //! @param offset Pozycja w pliku.
+  //! @param left Ilość danych pozostałych do wysłania.
+  //! @param sent Ilość wysłanych danych.
+  //! @param handler Funkcja do obsługi zapisu.
+  void send_file_direct(int fd,std::size_t offset,std::size_t left,std::size_t sent,handler_t && handler){
+    error_code_t ec;
+    while (left) {
+      off_t o(offset);
+      const ssize_t n(::sendfile(stream.lowest_layer().native_handle(),fd,&o,left));
+      if (0<n) {
+        offset+=n;
+        left-=n;
+        sent+=n;
+      } else if (n==0) {
+        //Plik jest krótszy niż podana ilość danych.
+        ec=::asio::error::eof;
+        break;
+      } else if (errno==EINTR) {
+        continue;
+      } else if ((errno==EAGAIN)||(errno==EWOULDBLOCK)) {
+        auto self(interface::enable_shared_t::shared_from_this());
+        strand.bind([self,this,fd,offset,left,sent,handler=std::move(handler)](const ict::asio::error_code_t& ec) mutable {
+          if (ec) {
+            complete(std::move(handler),ec,sent);
+          } else {
+            send_file_direct(fd,offset,left,sent,std::move(handler));
+          }
+        },[this](auto && h){
+          stream.lowest_layer().async_wait(::asio::socket_base::wait_write,std::move(h));
+        });
+        return;
+      } else {
+        ec=error_code_t(errno,std::generic_category());
+        break;
+      }
+    }
+    complete(std::move(handler),ec,sent);
+  }
+#endif
+  //! Wywołuje funkcję do obsługi zapisu lub odczytu (jeśli ustawiony jest priorytet - z kolejki tego priorytetu).
+  void complete(handler_t && handler,const ict::asio::error_code_t& ec,std::size_t s){
+    if (const std::optional<priority_t> p=strand.get_priority()){
+      strand.post(*p,[handler=std::move(handler),ec,s]() mutable {
         handler(ec,s);
       });
+    } else {
+      handler(ec,s);
+    }
+  }
+public:
+  void post(asio_handler_t handler){
+    strand.post(std::move(handler));
+  }
+  void set_priority(priority_t priority){
+    strand.set_priority(priority);
+  }
+  void set_options(const socket_options_t & options){
+    error_code_t ec;
+    set_options(options,ec);
+    if (ec) throw std::system_error(ec);
+  }
+  void set_options(const socket_options_t & options,error_code_t& ec){
+    ec.clear();
+    setSocketOptions(stream.lowest_layer(),options,ec);
+  }
+  void set_shutdown_timeout(const std::chrono::milliseconds & timeout){
+    auto self(interface::enable_shared_t::shared_from_this());
+    strand.dispatch([self,this,timeout](){
+      shutdown_timeout=timeout;
     });
   }
-  void post(const asio_handler_t &handler){
-    strand.post(handler);
+  ::asio::io_service & service(){
+    return(strand.context());
+  }
+  void dispatch(asio_handler_t handler){
+    strand.dispatch(std::move(handler));
   }
 };
 template <class Stream> class ifc_raw : public ifc<Stream>{
 public:
   ifc_raw(Stream & s):ifc<Stream>(s){}
+#ifdef __linux__
+  //! Wysyła dane z pliku funkcją sendfile() (patrz ifc::send_file_direct()).
+  void async_send_file(int fd,std::size_t offset,std::size_t length,interface::handler_t handler){
+    ifc<Stream>::async_send_file_direct(fd,offset,length,std::move(handler));
+  }
+#endif
   void close(){
     auto self(interface::enable_shared_t::shared_from_this());
     ifc<Stream>::strand.post([self,this](){
       ifc<Stream>::stream.close();
     });
   }
+  void abort(){
+    close();
+  }
   bool is_open() const {
     return(ifc<Stream>::stream.is_open());
   }
@@ -112,45 +551,265 @@ public:
     });
   }
 };
+//! Funkcja wyboru kontekstu SSL zapisana w SSL_CTX - podmieniana atomowo (std::atomic_store()), sni_callback() pobiera własną referencję.
+typedef std::shared_ptr<const context_selector_t> selector_ptr;
+//! Zwalnia funkcję wyboru kontekstu SSL zapisaną w SSL_CTX (patrz setContextSelector()).
+static void free_selector(void * parent,void * ptr,CRYPTO_EX_DATA * ad,int idx,long argl,void * argp){
+  delete (selector_ptr *)ptr;
+}
+//! Indeksy danych SSL i SSL_CTX dla SNI (nazwa serwera jest przechowywana w połączeniu - bez globalnej blokady).
 struct _sni_t{
+  //! Blokada instalacji funkcji sni_callback() w kontekście.
   std::mutex mutex;
-  std::map<::SSL*,std::string> map;
+  //! Indeks danych SSL ze wskaźnikiem do nazwy serwera (std::string).
+  const int index=::SSL_get_ex_new_index(0,nullptr,nullptr,nullptr,nullptr);
+  //! Indeks danych SSL_CTX z funkcją wyboru kontekstu (selector_ptr - obecny, gdy zainstalowano funkcję sni_callback()).
+  const int selector=::SSL_CTX_get_ex_new_index(0,nullptr,nullptr,nullptr,free_selector);
 };
 static _sni_t & _sni_(){
   static _sni_t s;
   return(s);
 }
 static int sni_callback(SSL * ssl,int * i, void * arg){
-  std::unique_lock<std::mutex> lock(_sni_().mutex);
   const char * name(::SSL_get_servername(ssl,TLSEXT_NAMETYPE_host_name));
-  if (name){
-    _sni_().map[ssl].assign(name);
-  } else {
-    _sni_().map[ssl].assign("");
+  std::string * sni((std::string *)::SSL_get_ex_data(ssl,_sni_().index));
+  if (sni) sni->assign(name?name:"");
+  if (name) {
+    ::SSL_CTX * current(::SSL_get_SSL_CTX(ssl));
+    const selector_ptr * holder((const selector_ptr *)::SSL_CTX_get_ex_data(current,_sni_().selector));
+    //Własna referencja - setContextSelector() może w tym czasie podmienić funkcję.
+    const selector_ptr selector(holder?std::atomic_load(holder):selector_ptr());
+    if (selector&&(*selector)) {
+      const context_ptr c((*selector)(name));
+      if (c&&(c!=current)) ::SSL_set_SSL_CTX(ssl,c);
+    }
   }
-  return(0);
+  return(SSL_TLSEXT_ERR_OK);
+}
+//! Instaluje funkcję sni_callback() w kontekście SSL (raz dla kontekstu - blokada tylko przy pierwszej instalacji).
+//! @returns Miejsce na funkcję wyboru kontekstu.
+static selector_ptr * install_sni(const context_ptr & c){
+  selector_ptr * holder((selector_ptr *)::SSL_CTX_get_ex_data(c,_sni_().selector));
+  if (holder) return(holder);
+  std::unique_lock<std::mutex> lock(_sni_().mutex);
+  holder=(selector_ptr *)::SSL_CTX_get_ex_data(c,_sni_().selector);
+  if (!holder){
+    holder=new selector_ptr;
+    ::SSL_CTX_set_ex_data(c,_sni_().selector,holder);
+    ::SSL_CTX_set_tlsext_servername_callback(c,sni_callback);
+  }
+  return(holder);
+}
+//! Pamięć podręczna sesji TLS klienta (patrz interface::async_handshake()).
+struct _session_t{
+  std::mutex mutex;
+  std::map<std::string,::SSL_SESSION*> map;
+  //! Indeks danych SSL z kluczem sesji.
+  const int index=::SSL_get_ex_new_index(0,nullptr,nullptr,nullptr,nullptr);
+  //! Indeks danych SSL_CTX - znacznik zainstalowanej funkcji session_callback().
+  const int installed=::SSL_CTX_get_ex_new_index(0,nullptr,nullptr,nullptr,nullptr);
+  ~_session_t(){
+    for (auto & s : map) ::SSL_SESSION_free(s.second);
+  }
+  //! Sprawdza, czy sesja wygasła.
+  static bool expired(const ::SSL_SESSION * s,long now){
+    return((::SSL_SESSION_get_time(s)+::SSL_SESSION_get_timeout(s))<=now);
+  }
+  //! Zwraca sesję dla klucza (z dodatkową referencją - do zwolnienia SSL_SESSION_free()) lub nullptr (brak sesji lub sesja wygasła).
+  ::SSL_SESSION * get(const std::string & key){
+    std::unique_lock<std::mutex> lock(mutex);
+    auto it(map.find(key));
+    if (it==map.end()) return(nullptr);
+    if (expired(it->second,::time(nullptr))){
+      ::SSL_SESSION_free(it->second);
+      map.erase(it);
+      return(nullptr);
+    }
+    ::SSL_SESSION_up_ref(it->second);
+    return(it->second);
+  }
+  //! Zapamiętuje sesję dla klucza (przejmuje referencję) - po osiągnięciu limitu usuwa sesje wygasłe, a następnie najstarszą.
+  void put(const std::string & key,::SSL_SESSION * session){
+    std::unique_lock<std::mutex> lock(mutex);
+    auto it(map.find(key));
+    if (it!=map.end()){
+      ::SSL_SESSION_free(it->second);
+      it->second=session;
+      return;
+    }
+    if (_session_cache_size_<=map.size()){
+      const long now(::time(nullptr));
+      for (auto i=map.begin();i!=map.end();) if (expired(i->second,now)){
+        ::SSL_SESSION_free(i->second);
+        i=map.erase(i);
+      } else {
+        ++i;
+      }
+    }
+    if (_session_cache_size_<=map.size()){
+      auto oldest(std::min_element(map.begin(),map.end(),[](const auto & a,const auto & b){
+        return(::SSL_SESSION_get_time(a.second)<::SSL_SESSION_get_time(b.second));
+      }));
+      ::SSL_SESSION_free(oldest->second);
+      map.erase(oldest);
+    }
+    map.emplace(key,session);
+  }
+};
+static _session_t & _session_(){
+  static _session_t s;
+  return(s);
+}
+//! Zapamiętuje nową sesję TLS (dla TLS 1.3 - po odebraniu biletu, już po uzgodnieniu połączenia).
+static int session_callback(SSL * ssl,SSL_SESSION * session){
+  const std::string * key((const std::string *)::SSL_get_ex_data(ssl,_session_().index));
+  if ((!key)||key->empty()) return(0);
+  _session_().put(*key,session);
+  return(1);
 }
 template <class Stream> class ifc_ssl : public ifc<Stream>{
 private:
   ::asio::ssl::context context;
+  //! Bufor dla połączonych danych zapisu wektorowego.
+  interface::buffer_t gather;
+  //! Bufor dla połączonych wiadomości z kolejki zapisu (patrz write_queue()).
+  interface::buffer_t queue_gather;
+  //! Klucz sesji TLS w pamięci podręcznej (patrz async_handshake()).
+  std::string session;
+  //! Nazwa serwera (SNI) - ustawiana przez klienta lub odebrana przez serwer (patrz sni_callback()).
+  std::string server_name;
+public:
+  using ifc<Stream>::async_write_some;
+  //! Uzgadnia połączenie - operacje zlecone w tym czasie są wstrzymywane (patrz ifc::initiate()), a po przekroczeniu czasu
+  //! lub błędzie uzgadniania gniazdo jest zamykane (bez close_notify) i wszystkie operacje kończą się błędem.
+  void async_handshake(bool server,const std::string & key,const std::chrono::milliseconds & timeout,error_handler_t handler){
+    auto self(interface::enable_shared_t::shared_from_this());
+    ifc<Stream>::strand.dispatch([self,this,server,key,timeout,handler=std::move(handler)]() mutable {
+      ::SSL * ssl(ifc<Stream>::stream.native_handle());
+      ifc<Stream>::handshaking=true;
+      if ((!server)&&key.size()){
+        session=key;
+        ::SSL_set_ex_data(ssl,_session_().index,&session);
+        if (::SSL_SESSION * s=_session_().get(session)){
+          ::SSL_set_session(ssl,s);
+          ::SSL_SESSION_free(s);
+        }
+      }
+      //Zegar działa w ::asio::io_service połączenia.
+      std::shared_ptr<::asio::steady_timer> timer(std::make_shared<::asio::steady_timer>(ict::asio::ioServiceOf(ifc<Stream>::stream.lowest_layer())));
+      std::shared_ptr<bool> expired(std::make_shared<bool>(false));
+      timer->expires_from_now(timeout);
+      ifc<Stream>::strand.bind([self,this,expired](const ict::asio::error_code_t& ec){
+        if (!ec){
+          //Przerwanie operacji gniazda kończy async_handshake().
+          *expired=true;
+          error_code_t e;
+          ifc<Stream>::stream.lowest_layer().cancel(e);
+        }
+      },[timer](auto && h){
+        timer->async_wait(std::move(h));
+      });
+      ifc<Stream>::strand.bind([self=std::move(self),this,timer,expired,handler=std::move(handler)](const ict::asio::error_code_t& ec) mutable {
+        timer->cancel();
+        const error_code_t e((*expired)?error_code_t(ETIMEDOUT,std::generic_category()):ec);
+        if (e) {
+          close_socket();
+        } else {
+          interface::info.resumed=::SSL_session_reused(ifc<Stream>::stream.native_handle());
+        }
+        ifc<Stream>::handshaked(e);
+        handler(e);
+      },[this,server](auto && h){
+        ifc<Stream>::stream.async_handshake(server?(::asio::ssl::stream_base::server):(::asio::ssl::stream_base::client),std::move(h));
+      });
+    });
+  }
+  //! Zapis wektorowy - ::asio::ssl::stream zapisuje tylko pierwszy bufor, więc bufory są łączone (do rozmiaru rekordu TLS).
+  void async_write_some(interface::buffers_t& buffers,interface::handler_t handler){
+    ifc<Stream>::initiate(std::move(handler),[this,&buffers](auto && h){
+      ::asio::const_buffer sequence;
+      gather.clear();
+      for (const interface::buffer_t * buffer : buffers) if (buffer&&buffer->size()){
+        if (gather.empty()&&(_tls_record_<=buffer->size())){
+          sequence=::asio::buffer(buffer->data(),buffer->size());
+          break;
+        }
+        const std::size_t n(std::min(buffer->size(),_tls_record_-gather.size()));
+        gather.insert(gather.end(),buffer->begin(),buffer->begin()+n);
+        if (_tls_record_<=gather.size()) break;
+      }
+      if (gather.size()) sequence=::asio::buffer(gather.data(),gather.size());
+      ifc<Stream>::stream.async_write_some(sequence,std::move(h));
+    });
+  }
+protected:
+  //! Zapis z kolejki - ::asio::ssl::stream szyfruje tylko pierwszy bufor w każdym zapisie, więc małe wiadomości są łączone
+  //! (do rozmiaru rekordu TLS), a wiadomość nie mniejsza niż rekord TLS jest zapisywana bez kopiowania.
+  void write_queue(){
+    std::size_t count(0);
+    ::asio::const_buffer sequence;
+    if (_tls_record_<=ifc<Stream>::queue.front().view.size()){
+      count=1;
+      sequence=ifc<Stream>::queue.front().view;
+    } else {
+      queue_gather.clear();
+      for (;(count<ifc<Stream>::queue.size())&&(count<_queue_gather_);count++){
+        const ::asio::const_buffer & view(ifc<Stream>::queue[count].view);
+        if (_tls_record_<(queue_gather.size()+view.size())) break;
+        const unsigned char * data(static_cast<const unsigned char *>(view.data()));
+        queue_gather.insert(queue_gather.end(),data,data+view.size());
+      }
+      sequence=::asio::buffer(queue_gather.data(),queue_gather.size());
+    }
+    auto self(interface::enable_shared_t::shared_from_this());
+    ifc<Stream>::strand.bind([self,this,count](const ict::asio::error_code_t& ec,std::size_t s){
+      ifc<Stream>::drained(ec,count);
+    },[this,sequence](auto && h){
+      ::asio::async_write(ifc<Stream>::stream,sequence,std::move(h));
+    });
+  }
 public:
-  template<class Socket> ifc_ssl(Socket & s,const context_ptr & c,const std::string & sni):context(c),ifc<Stream>(s,context){
-    std::unique_lock<std::mutex> lock(_sni_().mutex);
+  template<class Socket> ifc_ssl(Socket & s,const context_ptr & c,const std::string & sni):context(c),ifc<Stream>(s,context),server_name(sni){
     if (sni.size()) ::SSL_set_tlsext_host_name(ifc<Stream>::stream.native_handle(),sni.c_str());
-    ::SSL_CTX_set_tlsext_servername_callback(c,sni_callback);
-    _sni_().map[ifc<Stream>::stream.native_handle()].assign(sni);
+    ::SSL_set_ex_data(ifc<Stream>::stream.native_handle(),_sni_().index,&server_name);
+    install_sni(c);
   }
   ~ifc_ssl(){
-    std::unique_lock<std::mutex> lock(_sni_().mutex);
-    _sni_().map.erase(ifc<Stream>::stream.native_handle());
+    ::SSL_set_ex_data(ifc<Stream>::stream.native_handle(),_session_().index,nullptr);
+    ::SSL_set_ex_data(ifc<Stream>::stream.native_handle(),_sni_().index,nullptr);
   }
+  //! Zamyka połączenie - asynchroniczna wymiana close_notify, po jej zakończeniu lub po przekroczeniu czasu zamyka gniazdo.
   void close(){
     auto self(interface::enable_shared_t::shared_from_this());
     ifc<Stream>::strand.post([self,this](){
-      ifc<Stream>::stream.shutdown();
-      ifc<Stream>::stream.lowest_layer().close();
+      if (!ifc<Stream>::stream.lowest_layer().is_open()) return;
+      std::shared_ptr<::asio::steady_timer> timer(std::make_shared<::asio::steady_timer>(ict::asio::ioServiceOf(ifc<Stream>::stream.lowest_layer())));
+      timer->expires_from_now(ifc<Stream>::shutdown_timeout);
+      ifc<Stream>::strand.bind([self,this](const ict::asio::error_code_t& ec){
+        //Zamknięcie gniazda przerywa async_shutdown().
+        if (!ec) close_socket();
+      },[timer](auto && h){
+        timer->async_wait(std::move(h));
+      });
+      ifc<Stream>::strand.bind([self,this,timer](const ict::asio::error_code_t& ec){
+        timer->cancel();
+        close_socket();
+      },[this](auto && h){
+        ifc<Stream>::stream.async_shutdown(std::move(h));
+      });
+    });
+  }
+  void abort(){
+    auto self(interface::enable_shared_t::shared_from_this());
+    ifc<Stream>::strand.post([self,this](){
+      close_socket();
     });
   }
+  //! Zamyka gniazdo połączenia (bez zgłaszania błędów).
+  void close_socket(){
+    error_code_t ec;
+    ifc<Stream>::stream.lowest_layer().close(ec);
+  }
   bool is_open() const {
     return(ifc<Stream>::stream.lowest_layer().is_open());
   }
@@ -171,58 +830,25 @@ public:
     });
   }
   const std::string & getSNI() {
-    std::unique_lock<std::mutex> lock(_sni_().mutex);
-    return(_sni_().map.at(ifc<Stream>::stream.native_handle()));
+    return(server_name);
   };
 };
 //============================================
 interface_ptr get(::asio::ip::tcp::socket & socket){
   interface_ptr ptr(std::make_shared<ifc_raw<::asio::ip::tcp::socket>>(socket));
-  ptr->info[_socket_type_]=_tcp_;
-  ptr->info[_socket_enc_]=_0_;
-  try {
-    ptr->info[_socket_local_]=socket.local_endpoint().address().to_string()+_colon_+std::to_string(socket.local_endpoint().port());
-  } catch(...) {
-    ptr->info[_socket_local_]=_empty_;
-  }
-  try {
-    ptr->info[_socket_remote_]=socket.remote_endpoint().address().to_string()+_colon_+std::to_string(socket.remote_endpoint().port());
-  } catch(...) {
-    ptr->info[_socket_remote_]=_empty_;
-  }
+  ptr->info.tcp=true;
   return(ptr);
 }
 interface_ptr get(::asio::local::stream_protocol::socket & socket){
   interface_ptr ptr(std::make_shared<ifc_raw<::asio::local::stream_protocol::socket>>(socket));
-  ptr->info[_socket_type_]=_local_;
-  ptr->info[_socket_enc_]=_0_;
-  try {
-    ptr->info[_socket_local_]=socket.local_endpoint().path();
-  } catch(...){
-    ptr->info[_socket_local_]=_empty_;
-  }
-  try {
-    ptr->info[_socket_remote_]=socket.remote_endpoint().path();
-  } catch(...){
-    ptr->info[_socket_remote_]=_empty_;
-  }
+  ptr->info.tcp=false;
   return(ptr);
 }
 interface_ptr get(::asio::ip::tcp::socket & socket,const context_ptr & context,const std::string & setSNI){
   if (context){
     interface_ptr ptr(std::make_shared<ifc_ssl<::asio::ssl::stream<::asio::ip::tcp::socket>>>(socket,context,setSNI));
-    ptr->info[_socket_type_]=_tcp_;
-    ptr->info[_socket_enc_]=_1_;
-    try {
-      ptr->info[_socket_local_]=socket.local_endpoint().address().to_string()+_colon_+std::to_string(socket.local_endpoint().port());
-    } catch(...) {
-      ptr->info[_socket_local_]=_empty_;
-    }
-    try {
-      ptr->info[_socket_remote_]=socket.remote_endpoint().address().to_string()+_colon_+std::to_string(socket.remote_endpoint().port());
-    } catch(...){
-      ptr->info[_socket_remote_]=_empty_;
-    }
+    ptr->info.tcp=true;
+    ptr->info.encrypted=true;
     return(ptr);
   }
   return(get(socket));
@@ -230,22 +856,99 @@ interface_ptr get(::asio::ip::tcp::socket & socket,const context_ptr & context,c
 interface_ptr get(::asio::local::stream_protocol::socket & socket,const context_ptr & context,const std::string & setSNI){
   if (context){
     interface_ptr ptr(std::make_shared<ifc_ssl<::asio::ssl::stream<::asio::local::stream_protocol::socket>>>(socket,context,setSNI));
-    ptr->info[_socket_type_]=_local_;
-    ptr->info[_socket_enc_]=_1_;
-    try {
-      ptr->info[_socket_local_]=socket.local_endpoint().path();
-    } catch(...){
-      ptr->info[_socket_local_]=_empty_;
-    }
-    try {
-      ptr->info[_socket_remote_]=socket.remote_endpoint().path();
-    } catch(...){
-      ptr->info[_socket_remote_]=_empty_;
-    }
+    ptr->info.tcp=false;
+    ptr->info.encrypted=true;
     return(ptr);
   }
   return(get(socket));
 }
+void interface::fill(map_info_t & m) const {
+  m[_socket_type_]=info.tcp?_tcp_:_local_;
+  m[_socket_enc_]=info.encrypted?_1_:_0_;
+  m[_socket_local_]=getLocal();
+  m[_socket_remote_]=getRemote();
+  if (info.encrypted){
+    m[_socket_resumed_]=info.resumed?_1_:_0_;
+    //Szyfrowanie zawsze w przestrzeni użytkownika (::asio::ssl::stream używa pary BIO w pamięci - kTLS nie jest dostępny).
+    m[_socket_ktls_]=_0_;
+  }
+  if (info.connector) m.insert(info.connector->begin(),info.connector->end());
+}
+std::string & interface::info_t::operator[](const std::string & key){
+  return(owner->getInfoMap()[key]);
+}
+std::string & interface::info_t::at(const std::string & key){
+  return(owner->getInfoMap().at(key));
+}
+std::size_t interface::info_t::count(const std::string & key){
+  return(owner->getInfoMap().count(key));
+}
+map_info_t::iterator interface::info_t::find(const std::string & key){
+  return(owner->getInfoMap().find(key));
+}
+map_info_t::iterator interface::info_t::begin(){
+  return(owner->getInfoMap().begin());
+}
+map_info_t::iterator interface::info_t::end(){
+  return(owner->getInfoMap().end());
+}
+map_info_t & interface::getInfoMap(){
+  if (!map) map.reset(new map_info_t());
+  fill(*map);
+  return(*map);
+}
+std::string interface::getInfo() const {
+  map_info_t m;
+  if (map) m=*map;
+  fill(m);
+  std::string o;
+  for (map_info_t::const_iterator it=m.begin();it!=m.end();++it){
+    if (it!=m.begin()) o+=",";
+    o+=it->first;
+    o+="=";
+    o+=it->second;
+  }
+  return(o);
+}
+void setSessionCache(const context_ptr & context){
+  std::unique_lock<std::mutex> lock(_session_().mutex);
+  if (::SSL_CTX_get_ex_data(context,_session_().installed)) return;
+  //Wewnętrzna pamięć podręczna serwera pozostaje bez zmian.
+  ::SSL_CTX_set_session_cache_mode(context,::SSL_CTX_get_session_cache_mode(context)|SSL_SESS_CACHE_CLIENT);
+  ::SSL_CTX_sess_set_new_cb(context,session_callback);
+  ::SSL_CTX_set_ex_data(context,_session_().installed,context);
+}
+void setServerNameCallback(const context_ptr & context){
+  install_sni(context);
+}
+void setContextSelector(const context_ptr & context,const context_selector_t & selector){
+  std::atomic_store(install_sni(context),selector_ptr(std::make_shared<const context_selector_t>(selector)));
+}
+void post(const std::vector<interface_ptr> & connections,const batch_handler_t & handler){
+  typedef std::pair<::asio::io_service*,std::vector<asio_handler_t>> group_t;
+  std::vector<group_t> groups;
+  std::shared_ptr<const batch_handler_t> h(std::make_shared<const batch_handler_t>(handler));
+  for (const interface_ptr & ptr : connections) if (ptr) {
+    batch_ifc * b(dynamic_cast<batch_ifc*>(ptr.get()));
+    if (!b) {
+      ptr->post([ptr,h](){
+        (*h)(ptr);
+      });
+      continue;
+    }
+    ::asio::io_service * io(&b->service());
+    std::vector<group_t>::iterator it(std::find_if(groups.begin(),groups.end(),[io](const group_t & g){
+      return(g.first==io);
+    }));
+    if (it==groups.end()) it=groups.emplace(groups.end(),io,std::vector<asio_handler_t>());
+    it->second.emplace_back([ptr,b,h](){
+      b->dispatch([ptr,h](){
+        (*h)(ptr);
+      });
+    });
+  }
+  for (group_t & g : groups) ict::asio::ioServicePost(*g.first,std::move(g.second));
+}
 //============================================
 }}}
 //============================================
@@ -253,6 +956,9 @@ interface_ptr get(::asio::local::stream_protocol::socket & socket,const context_
 #include "test.hpp"
 #include "asio.hpp"
 #include "connector.hpp"
+#include "connection-string.h"
+#include <future>
+#include <functional>
 static int test__connection(ict::asio::context_ptr & s_ctx,ict::asio::context_ptr & c_ctx){
   ict::asio::ioSignal();
   ict::asio::ioRun();
@@ -371,5 +1077,493 @@ REGISTER_TEST(connection,tc1){
   ict::asio::context_ptr ctx=NULL;
   return(test__connection(ctx,ctx));
 }
+struct test__echo_t {
+  ict::asio::connection::interface_ptr ptr;
+  ict::asio::connection::interface::buffer_t buffer;
+  std::size_t received=0;
+  std::function<void()> read;
+  std::function<void()> write;
+};
+static void test__echo_write(test__echo_t & e,std::size_t size,const std::function<void()> & done){
+  e.buffer.resize(size);
+  e.ptr->async_write_some(e.buffer,[&e,size,done](const ict::asio::error_code_t& ec,std::size_t s){
+    if (ec) return;
+    if (s<size){
+      e.buffer.erase(e.buffer.begin(),e.buffer.begin()+s);
+      test__echo_write(e,size-s,done);
+    } else done();
+  });
+}
+static double test__echo(const std::string & host,const std::string & port,std::size_t size,std::size_t count){
+  ict::asio::ioRun();
+  std::promise<double> result;
+  std::atomic_flag finished=ATOMIC_FLAG_INIT;
+  auto finish=[&](double r){
+    if (!finished.test_and_set()) result.set_value(r);
+  };
+  std::chrono::steady_clock::time_point start;
+  std::size_t left=count;
+  test__echo_t server,client;
+  ict::asio::connector::interface_ptr s1(port.empty()?ict::asio::connector::get(host,true):ict::asio::connector::get(host,port,true));
+  ict::asio::connector::interface_ptr c1(port.empty()?ict::asio::connector::get(host,false):ict::asio::connector::get(host,port,false));
+  server.read=[&](){
+    server.buffer.resize(size);
+    server.ptr->async_read_some(server.buffer,[&](const ict::asio::error_code_t& ec,std::size_t s){
+      if (ec) return;
+      test__echo_write(server,s,server.read);
+    });
+  };
+  client.write=[&](){
+    client.buffer.assign(size,'x');
+    client.received=0;
+    test__echo_write(client,size,client.read);
+  };
+  client.read=[&](){
+    client.buffer.resize(size-client.received);
+    client.ptr->async_read_some(client.buffer,[&](const ict::asio::error_code_t& ec,std::size_t s){
+      if (ec){
+        finish(-1);
+        return;
+      }
+      client.received+=s;
+      if (client.received<size){
+        client.read();
+      } else if (--left){
+        client.write();
+      } else {
+        finish(count/std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count());
+      }
+    });
+  };
+  s1->async_connection([&](const ict::asio::error_code_t& ec,ict::asio::connection::interface_ptr ptr){
+    if (ec||!ptr) return;
+    server.ptr=ptr;
+    server.read();
+  });
+  usleep(5000);
+  c1->async_connection([&](const ict::asio::error_code_t& ec,ict::asio::connection::interface_ptr ptr){
+    if (ec||!ptr){
+      finish(-1);
+      return;
+    }
+    client.ptr=ptr;
+    start=std::chrono::steady_clock::now();
+    client.write();
+  });
+  std::future<double> f(result.get_future());
+  const double r((f.wait_for(std::chrono::seconds(60))==std::future_status::ready)?f.get():-1);
+  finish(-1);
+  if (server.ptr) server.ptr->close();
+  if (client.ptr) client.ptr->close();
+  s1->close();
+  c1->close();
+  usleep(10000);
+  ict::asio::ioStop();
+  ict::asio::ioJoin();
+  return(r);
+}
+REGISTER_TEST(connection,tc2){
+  const std::size_t size=64;
+  const std::size_t count=20000;
+  srand(time(NULL));
+  const double tcp(test__echo("localhost","301"+std::to_string(rand()%90+10),size,count));
+  const double local(test__echo("/tmp/ict-asio-echo-"+std::to_string(getpid()),"",size,count));
+  std::cout<<"backend: "<<ict::asio::ioServiceBackend()<<" (io_uring supported by kernel: "<<(ict::asio::ioUringSupported()?"yes":"no")<<")"<<std::endl;
+  std::cout<<"tcp echo "<<size<<"B: "<<tcp<<" msg/s"<<std::endl;
+  std::cout<<"local echo "<<size<<"B: "<<local<<" msg/s"<<std::endl;
+  if ((tcp<0)||(local<0)) return(-1);
+  return(0);
+}
+template<class Post> static double test__fanout(std::size_t n,std::size_t rounds,const Post & post){
+  std::atomic<std::size_t> done(0);
+  const auto start(std::chrono::steady_clock::now());
+  for (std::size_t r=0;r<rounds;r++) post(done);
+  for (int i=0;(i<60000)&&(done<(n*rounds));i++) usleep(1000);
+  if (done!=(n*rounds)) return(-1);
+  return(std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now()-start).count()/(n*rounds));
+}
+REGISTER_TEST(connection,tc3){
+  const std::size_t n=1000;
+  const std::size_t rounds=100;
+  std::vector<::asio::local::stream_protocol::socket> sockets;
+  std::vector<ict::asio::connection::interface_ptr> connections;
+  ict::asio::ioConfig().threads=2;
+  for (std::size_t i=0;i<n;i++){
+    ::asio::local::stream_protocol::socket a(ict::asio::ioService()),b(ict::asio::ioService());
+    ::asio::local::connect_pair(a,b);
+    connections.push_back(ict::asio::connection::get(a));
+    sockets.push_back(std::move(b));
+  }
+  ict::asio::ioRun();
+  const double handlerSingle(test__fanout(n,rounds,[n](std::atomic<std::size_t> & done){
+    for (std::size_t i=0;i<n;i++) ict::asio::ioServicePost([&done](){done++;});
+  }));
+  const double handlerBatch(test__fanout(n,rounds,[n](std::atomic<std::size_t> & done){
+    std::vector<ict::asio::asio_handler_t> handlers;
+    handlers.reserve(n);
+    for (std::size_t i=0;i<n;i++) handlers.emplace_back([&done](){done++;});
+    ict::asio::ioServicePost(std::move(handlers));
+  }));
+  const double connectionSingle(test__fanout(n,rounds,[&connections](std::atomic<std::size_t> & done){
+    for (const ict::asio::connection::interface_ptr & ptr : connections) ptr->post([&done](){done++;});
+  }));
+  const double connectionBatch(test__fanout(n,rounds,[&connections](std::atomic<std::size_t> & done){
+    ict::asio::connection::post(connections,[&done](const ict::asio::connection::interface_ptr & ptr){done++;});
+  }));
+  for (const ict::asio::connection::interface_ptr & ptr : connections) ptr->close();
+  usleep(10000);
+  ict::asio::ioStop();
+  ict::asio::ioJoin();
+  std::cout<<"ioServicePost() x "<<n<<": "<<handlerSingle<<" ns/handler"<<std::endl;
+  std::cout<<"ioServicePost(std::vector) "<<n<<": "<<handlerBatch<<" ns/handler"<<std::endl;
+  std::cout<<"connection::interface::post() x "<<n<<": "<<connectionSingle<<" ns/connection"<<std::endl;
+  std::cout<<"connection::post(std::vector) "<<n<<": "<<connectionBatch<<" ns/connection"<<std::endl;
+  if ((handlerSingle<0)||(handlerBatch<0)||(connectionSingle<0)||(connectionBatch<0)) return(-1);
+  return(0);
+}
+//! Para połączeń przez gniazda lokalne z uruchomionymi wątkami ioRun() (wspólna część testów operacji na połączeniu).
+struct test__pair_t {
+  std::promise<int> result;
+  std::atomic_flag finished=ATOMIC_FLAG_INIT;
+  ict::asio::connection::interface_ptr writer,reader;
+  test__pair_t(){
+    ::asio::local::stream_protocol::socket a(ict::asio::ioService()),b(ict::asio::ioService());
+    ::asio::local::connect_pair(a,b);
+    writer=ict::asio::connection::get(a);
+    reader=ict::asio::connection::get(b);
+    ict::asio::ioRun();
+  }
+  //! Przekazuje wynik testu (tylko pierwsze wywołanie).
+  //! @param r Wynik testu.
+  void done(int r){
+    if (!finished.test_and_set()) result.set_value(r);
+  }
+  //! Czeka na wynik testu, a następnie zamyka połączenia i zatrzymuje wątki ioRun().
+  //! @param timeout Wynik testu, gdy nie zakończy się w ciągu 10 s.
+  //! @returns Wynik testu.
+  int wait(int timeout){
+    std::future<int> f(result.get_future());
+    const int r((f.wait_for(std::chrono::seconds(10))==std::future_status::ready)?f.get():timeout);
+    writer->abort();
+    reader->abort();
+    ict::asio::ioStop();
+    ict::asio::ioJoin();
+    return(r);
+  }
+};
+REGISTER_TEST(connection,tc4){
+  test__pair_t t;
+  ict::asio::connection::interface::buffer_t header={'h','e','a','d'},body={'b','o','d','y','!'},trailer={'e','n','d'};
+  ict::asio::connection::interface::buffer_t first(6),second(6);
+  ict::asio::connection::interface::buffers_t out={&header,&body,&trailer};
+  ict::asio::connection::interface::buffers_t in={&first,&second};
+  t.writer->async_write_some(out,[&](const ict::asio::error_code_t& ec,std::size_t s){
+    if (ec||(s!=12)) {
+      t.done(-1);
+      return;
+    }
+    t.reader->async_read_some(in,[&](const ict::asio::error_code_t& ec,std::size_t s){
+      if (ec||(s!=12)) {
+        t.done(-2);
+        return;
+      }
+      const std::string data(std::string(first.begin(),first.end())+std::string(second.begin(),second.end()));
+      t.done((data=="headbody!end")?0:-3);
+    });
+  });
+  return(t.wait(-4));
+}
+REGISTER_TEST(connection,tc5){
+  test__pair_t t;
+  const std::string text("GET / HTTP/1.1\r\nbody");
+  ict::asio::connection::interface::buffer_t out(text.begin(),text.end());
+  ict::asio::connection::interface::buffer_t line,rest;
+  t.writer->async_write_all(out,[&](const ict::asio::error_code_t& ec,std::size_t s){
+    if (ec||(s!=out.size())) {
+      t.done(-1);
+      return;
+    }
+    t.reader->async_read_until(line,"\r\n",[&](const ict::asio::error_code_t& ec,std::size_t s){
+      if (ec||(s!=16)||(std::string(line.begin(),line.begin()+s)!="GET / HTTP/1.1\r\n")) {
+        t.done(-2);
+        return;
+      }
+      //Dane odczytane za ogranicznikiem.
+      const std::string extra(line.begin()+s,line.end());
+      rest.resize(4-extra.size());
+      t.reader->async_read_exact(rest,[&,extra](const ict::asio::error_code_t& ec,std::size_t s){
+        if (ec||(s!=rest.size())) {
+          t.done(-3);
+          return;
+        }
+        t.done(((extra+std::string(rest.begin(),rest.end()))=="body")?0:-4);
+      });
+    });
+  });
+  return(t.wait(-5));
+}
+//! Liczba zadań wykonanych przez wątki ioRun() (patrz ioMonitorSnapshot()).
+static std::size_t test__handlers(){
+  std::size_t handlers(0);
+  for (const ict::asio::monitor_worker_t & w : ict::asio::ioMonitorSnapshot().workers) handlers+=w.handlers;
+  return(handlers);
+}
+//! Echo wiadomości 64-bajtowych - zwraca liczbę zadań wykonanych w czasie testu, od uruchomienia do zakończenia wątków
+//! (lub wartość ujemną - błąd). Kolejne operacje są uruchamiane bezpośrednio z funkcji zakończenia poprzedniej operacji.
+static long test__echo_handlers(std::size_t count){
+  std::promise<int> result;
+  std::future<int> f(result.get_future());
+  ::asio::local::stream_protocol::socket a(ict::asio::ioService()),b(ict::asio::ioService());
+  ::asio::local::connect_pair(a,b);
+  ict::asio::connection::interface_ptr client(ict::asio::connection::get(a));
+  ict::asio::connection::interface_ptr server(ict::asio::connection::get(b));
+  const std::string message(64,'x');
+  ict::asio::connection::interface::buffer_t clientReadBuffer(message.size()),serverBuffer(message.size());
+  std::size_t left=count;
+  std::function<void()> serverRead,clientWrite;
+  serverRead=[&](){
+    server->async_read_exact(serverBuffer,[&](const ict::asio::error_code_t& ec,std::size_t){
+      if (ec) return;
+      server->async_write_all(serverBuffer,[&](const ict::asio::error_code_t& ec,std::size_t){
+        if (!ec) serverRead();
+      });
+    });
+  };
+  clientWrite=[&](){
+    client->async_write_all(::asio::const_buffer(message.data(),message.size()),[&](const ict::asio::error_code_t& ec,std::size_t){
+      //Błąd zapisu kończy odczyt.
+      if (ec) client->abort();
+    });
+    client->async_read_exact(clientReadBuffer,[&](const ict::asio::error_code_t& ec,std::size_t){
+      if (ec){
+        result.set_value(-2);
+      } else if (--left){
+        clientWrite();
+      } else {
+        result.set_value(0);
+      }
+    });
+  };
+  const std::size_t before(test__handlers());
+  ict::asio::ioRun();
+  serverRead();
+  clientWrite();
+  int r(-3);
+  if (f.wait_for(std::chrono::seconds(60))==std::future_status::ready) r=f.get();
+  client->abort();
+  server->abort();
+  ict::asio::ioStop();
+  ict::asio::ioJoin();
+  //Zadania pozostałe po zatrzymaniu (zamknięcie połączeń) są wykonywane tutaj - nie trafiają do następnego testu.
+  ict::asio::ioService().restart();
+  while (ict::asio::ioService().poll()){}
+  return(r?r:(long)(test__handlers()-before));
+}
+REGISTER_TEST(connection,tc6){
+  const std::size_t count=1000;
+  ict::asio::ioConfig().threads=1;
+  ict::asio::ioMonitorStart();
+  //Różnica dwóch testów nie zawiera zadań stałych (uruchomienie i zamknięcie połączeń).
+  const long first(test__echo_handlers(count));
+  const long second(test__echo_handlers(2*count));
+  ict::asio::ioMonitorStop();
+  ict::asio::ioConfig().threads=0;
+  if (first<0) return(-1);
+  if (second<0) return(-2);
+  const long handlers(second-first);
+  std::cout<<"handlers per echoed message: "<<((double)handlers/count)<<std::endl;
+  //Jedno zadanie na operację (zapis i odczyt po obu stronach) - bez dodatkowego post() do ::asio::strand.
+  if (handlers!=(long)(4*count)) return(-3);
+  return(0);
+}
+REGISTER_TEST(connection,tc7){
+  test__pair_t t;
+  //Ten sam bufor współdzielony może być wysłany do wielu połączeń bez kopiowania.
+  const std::shared_ptr<const std::string> shared(std::make_shared<const std::string>("shared|"));
+  const char view[]="view";
+  char in[11];
+  t.writer->async_write_all(shared,[&](const ict::asio::error_code_t& ec,std::size_t s){
+    if (ec||(s!=shared->size())) {
+      t.done(-1);
+      return;
+    }
+    t.writer->async_write_all(::asio::const_buffer(view,4),[&](const ict::asio::error_code_t& ec,std::size_t s){
+      if (ec||(s!=4)) {
+        t.done(-2);
+        return;
+      }
+      t.reader->async_read_exact(::asio::mutable_buffer(in,sizeof(in)),[&](const ict::asio::error_code_t& ec,std::size_t s){
+        if (ec||(s!=sizeof(in))) {
+          t.done(-3);
+          return;
+        }
+        t.done((std::string(in,sizeof(in))=="shared|view")?0:-4);
+      });
+    });
+  });
+  return(t.wait(-5));
+}
+REGISTER_TEST(connection,tc8){
+  ::asio::ip::tcp::acceptor acceptor(ict::asio::ioService(),::asio::ip::tcp::endpoint(::asio::ip::address_v4::loopback(),0));
+  ::asio::ip::tcp::socket a(ict::asio::ioService()),b(ict::asio::ioService());
+  a.connect(acceptor.local_endpoint());
+  acceptor.accept(b);
+  ::asio::ip::tcp::socket::native_handle_type fd(a.native_handle());
+  ict::asio::connection::interface_ptr ptr(ict::asio::connection::get(a));
+  ict::asio::socket_options_t options;
+  options.no_delay=true;
+  options.send_buffer=0x20000;
+  options.keep_alive=true;
+  ict::asio::error_code_t ec;
+  ptr->set_options(options,ec);
+  if (ec) {
+    std::cout<<"set_options: "<<ec.message()<<std::endl;
+    return(-1);
+  }
+  int value(0);
+  socklen_t size(sizeof(value));
+  if (::getsockopt(fd,IPPROTO_TCP,TCP_NODELAY,&value,&size)||!value) return(-2);
+  if (::getsockopt(fd,SOL_SOCKET,SO_KEEPALIVE,&value,&size)||!value) return(-3);
+  //Lokalne gniazda ignorują opcje TCP.
+  ::asio::local::stream_protocol::socket c(ict::asio::ioService()),d(ict::asio::ioService());
+  ::asio::local::connect_pair(c,d);
+  ict::asio::connection::interface_ptr local(ict::asio::connection::get(c));
+  local->set_options(options,ec);
+  if (ec) {
+    std::cout<<"set_options (local): "<<ec.message()<<std::endl;
+    return(-4);
+  }
+  ptr->close();
+  local->close();
+  return(0);
+}
+REGISTER_TEST(connection,tc9){
+  //Plik większy niż bufor gniazda - wymaga oczekiwania na możliwość zapisu.
+  const std::size_t size(0x400000),offset(100);
+  char path[]="/tmp/test-connection-XXXXXX";
+  int fd(::mkstemp(path));
+  if (fd<0) return(-1);
+  ::unlink(path);
+  std::string content(size,0);
+  for (std::size_t k=0;k<size;k++) content[k]=(char)(k%251);
+  if (::write(fd,content.data(),size)!=(ssize_t)size) {
+    ::close(fd);
+    return(-2);
+  }
+  test__pair_t t;
+  ict::asio::connection::interface::buffer_t in(size-offset);
+  std::atomic<int> done(0);
+  std::atomic<bool> failed(false);
+  auto finish=[&](bool error){
+    if (error) failed=true;
+    if (++done==2) t.done(failed?-3:((std::string(in.begin(),in.end())==content.substr(offset))?0:-4));
+  };
+  t.writer->async_send_file(fd,offset,size-offset,[&](const ict::asio::error_code_t& ec,std::size_t s){
+    finish(ec||(s!=(size-offset)));
+  });
+  t.reader->async_read_exact(in,[&](const ict::asio::error_code_t& ec,std::size_t s){
+    finish(ec||(s!=in.size()));
+  });
+  const int r(t.wait(-5));
+  ::close(fd);
+  return(r);
+}
+REGISTER_TEST(connection,tc10){
+  const std::shared_ptr<const ict::asio::map_info_t> connector(std::make_shared<const ict::asio::map_info_t>(ict::asio::map_info_t{{"connector_type","local"}}));
+  {
+    ::asio::local::stream_protocol::socket a(ict::asio::ioService()),b(ict::asio::ioService());
+    ::asio::local::connect_pair(a,b);
+    ict::asio::connection::interface_ptr ptr(ict::asio::connection::get(a));
+    ptr->info.connector=connector;
+    //Te same klucze i wartości, które były wpisywane do mapy przez connection::get() i konektor.
+    const ict::asio::map_info_t expected{
+      {"connector_type","local"},{"socket_enc","0"},{"socket_local",""},{"socket_remote",""},{"socket_type","local"}
+    };
+    if (ptr->getInfoMap()!=expected) return(-1);
+    if (ptr->getInfo()!="connector_type=local,socket_enc=0,socket_local=,socket_remote=,socket_type=local") return(-2);
+    //Dostęp zgodny z map_info_t.
+    if ((ptr->info["socket_type"]!="local")||(ptr->info.at("connector_type")!="local")||(ptr->info.count("socket_enc")!=1)) return(-3);
+    ptr->info["user"]="x";
+    if ((ptr->getInfoMap().at("user")!="x")||(ptr->info.find("user")==ptr->info.end())) return(-4);
+    if (ptr->getInfo().find("user=x")==std::string::npos) return(-5);
+    std::size_t n(0);
+    for (const auto & e : ptr->info) if (e.second==ptr->getInfoMap().at(e.first)) n++;
+    if (n!=expected.size()+1) return(-6);
+  }
+  {
+    ::asio::ip::tcp::acceptor acceptor(ict::asio::ioService(),::asio::ip::tcp::endpoint(::asio::ip::address_v4::loopback(),0));
+    ::asio::ip::tcp::socket a(ict::asio::ioService()),b(ict::asio::ioService());
+    a.connect(acceptor.local_endpoint());
+    acceptor.accept(b);
+    const std::string local(a.local_endpoint().address().to_string()+":"+std::to_string(a.local_endpoint().port()));
+    const std::string remote(a.remote_endpoint().address().to_string()+":"+std::to_string(a.remote_endpoint().port()));
+    ict::asio::connection::interface_ptr ptr(ict::asio::connection::get(a));
+    const ict::asio::map_info_t expected{
+      {"socket_enc","0"},{"socket_local",local},{"socket_remote",remote},{"socket_type","tcp"}
+    };
+    if (ptr->getInfoMap()!=expected) return(-7);
+    if (ptr->getInfo()!=("socket_enc=0,socket_local="+local+",socket_remote="+remote+",socket_type=tcp")) return(-8);
+    if ((ptr->getLocal()!=local)||(ptr->getRemote()!=remote)) return(-9);
+  }
+  return(0);
+}
+REGISTER_TEST(connection,tc11){
+  const std::size_t count(256),size(0x4000),low(0x40000),high(0x100000);
+  test__pair_t t;
+  std::atomic<int> pauses(0),resumes(0),parts(0);
+  std::atomic<std::size_t> written(0);
+  //Stan producenta - dostęp tylko w ramach ::asio::strand połączenia.
+  std::size_t produced(0),peak(0);
+  bool stopped(false);
+  //Sprawdzenie po zapisie wszystkich wiadomości i ich odczycie - w ramach ::asio::strand, po zakończeniu drained() (wznowienie).
+  //Liczba wstrzymań zależy od szybkości odczytu - sprawdzane są tylko: co najmniej jedno wstrzymanie, każde wstrzymanie
+  //zakończone wznowieniem oraz ograniczony rozmiar kolejki.
+  auto finish=[&](){
+    if (++parts==2) t.writer->post([&](){
+      t.done(((pauses<1)||(pauses!=resumes)||((high+size)<peak)||(written!=count*size)||t.writer->queued())?-4:0);
+    });
+  };
+  std::function<void()> produce;
+  produce=[&](){
+    for (;(produced<count)&&(!stopped);produced++){
+      ict::asio::connection::interface::buffer_t data(size,(unsigned char)produced);
+      t.writer->enqueue(std::move(data),[&](const ict::asio::error_code_t& ec,std::size_t s){
+        if (ec) {
+          t.done(-3);
+          return;
+        }
+        if ((written+=s)==count*size) finish();
+      });
+      peak=std::max(peak,t.writer->queued());
+    }
+  };
+  //Producent wstrzymuje dodawanie wiadomości po przekroczeniu progu górnego i wznawia po spadku do progu dolnego.
+  t.writer->set_watermarks(low,high,[&](bool pause){
+    if (pause) {
+      pauses++;
+      stopped=true;
+    } else {
+      resumes++;
+      stopped=false;
+      t.writer->post(produce);
+    }
+  });
+  ict::asio::connection::interface::buffer_t in(count*size);
+  t.reader->async_read_exact(in,[&](const ict::asio::error_code_t& ec,std::size_t s){
+    if (ec||(s!=in.size())) {
+      t.done(-1);
+      return;
+    }
+    for (std::size_t k=0;k<in.size();k++) if (in[k]!=(unsigned char)(k/size)) {
+      t.done(-2);
+      return;
+    }
+    finish();
+  });
+  t.writer->post(produce);
+  const int r(t.wait(-5));
+  std::cout<<"pauses: "<<pauses<<", resumes: "<<resumes<<", peak: "<<peak<<std::endl;
+  return(r);
+}
 #endif
 //===========================================
\ No newline at end of file
@@ -61,6 +61,12 @@ interface_ptr get(::asio::ip::tcp::socket & socket,const context_ptr & context,c
 //! @param setSNI Ustawia nazwę serwera (SNI) - gdy połączenie jako klient.
 //! @returns Wskaźnik do interfejsu do obsługi połączenia.
 interface_ptr get(::asio::local::stream_protocol::socket & socket,const context_ptr & context,const std::string & setSNI="");
+//! Włącza pamięć podręczną sesji TLS klienta w kontekście SSL (raz dla kontekstu - przed utworzeniem połączeń, patrz interface::async_handshake()).
+//! @param context Wskaźnik do kontekstu połączenia SSL.
+void setSessionCache(const context_ptr & context);
+//! Instaluje obsługę SNI w kontekście SSL (raz dla kontekstu - przed utworzeniem połączeń, patrz setContextSelector()).
+//! @param context Wskaźnik do kontekstu połączenia SSL.
+void setServerNameCallback(const context_ptr & context);
 //============================================
 }}}
 //===========================================
@@ -38,6 +38,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vector>
 #include <string>
 #include <memory>
+#include <chrono>
+#include <asio/buffer.hpp>
 #include "types.hpp"
 //============================================
 namespace ict { namespace asio { namespace connection {
@@ -47,27 +49,65 @@ class interface : public std::enable_shared_from_this<interface> {
 public:
   //! Typ pomocniczy do generowania wskaźnika.
   typedef  std::enable_shared_from_this<interface> enable_shared_t;
-  //! Typ - Funkcja do obsługi zapisu lub odczytu.
-  typedef std::function<void(const ict::asio::error_code_t&,std::size_t)> handler_t;
+  //! Typ - Funkcja do obsługi zapisu lub odczytu (może być przenoszona, nie musi być kopiowalna).
+  typedef unique_function<void(const ict::asio::error_code_t&,std::size_t)> handler_t;
   //! Typ - Bufor do odczytu lub zapisu (Uwaga: rozmiar musi być ustawiony przed użyciem!).
   typedef std::vector<unsigned char> buffer_t;
+  //! Typ - Lista buforów do zapisu lub odczytu wektorowego (bufory muszą istnieć do zakończenia operacji).
+  typedef std::vector<buffer_t*> buffers_t;
+  //! Typ - Funkcja wywoływana po przekroczeniu progów kolejki zapisu (true - wstrzymać dodawanie danych, false - wznowić).
+  typedef std::function<void(bool pause)> watermark_handler_t;
+  //! Typ - Metadane połączenia (typowane - tekst jest tworzony dopiero na żądanie, patrz getInfoMap()).
+  //! Dostęp przez klucz (info["socket_type"], at(), count(), find(), begin(), end()) działa jak dla map_info_t - na mapie z getInfoMap().
+  struct info_t {
+    //! Metadane konektora - wspólne dla wszystkich połączeń konektora (bez kopiowania).
+    std::shared_ptr<const map_info_t> connector;
+    //! Typ gniazda (true - TCP, false - gniazdo lokalne).
+    bool tcp=true;
+    //! Informacja, czy połączenie jest szyfrowane.
+    bool encrypted=false;
+    //! Informacja, czy sesja TLS została wznowiona.
+    bool resumed=false;
+    //! Zwraca wpis mapy metadanych (patrz getInfoMap()).
+    //! @param key Klucz.
+    std::string & operator[](const std::string & key);
+    std::string & at(const std::string & key);
+    std::size_t count(const std::string & key);
+    map_info_t::iterator find(const std::string & key);
+    map_info_t::iterator begin();
+    map_info_t::iterator end();
+  private:
+    friend class interface;
+    //! Połączenie, do którego należą metadane.
+    interface * owner=nullptr;
+  };
   //! Metadane połączenia
-  map_info_t info;
-  std::string getInfo() const {
-    std::string o;
-    for (map_info_t::const_iterator it=info.begin();it!=info.end();++it){
-      if (it!=info.begin()) o+=",";
-      o+=it->first;
-      o+="=";
-      o+=it->second;
-    }
-    return(o);
+  info_t info;
+  //! Konstruktor.
+  interface(){
+    info.owner=this;
   }
+  //! Zwraca adres lokalny połączenia (formatowany przy wywołaniu).
+  virtual std::string getLocal() const=0;
+  //! Zwraca adres zdalny połączenia (formatowany przy wywołaniu).
+  virtual std::string getRemote() const=0;
+  //! Zwraca metadane połączenia jako mapę (mapa jest tworzona przy pierwszym wywołaniu, dodane do niej wpisy są zachowywane).
+  map_info_t & getInfoMap();
+  //! Zwraca metadane połączenia jako tekst (klucz=wartość,...).
+  std::string getInfo() const;
+private:
+  //! Mapa metadanych (patrz getInfoMap()).
+  std::unique_ptr<map_info_t> map;
+  //! Wypełnia mapę metadanymi połączenia i konektora (nie nadpisuje wpisów konektora, które już są w mapie).
+  //! @param m Mapa.
+  void fill(map_info_t & m) const;
 public:
   //! Destruktor
   virtual ~interface(){}
-  //! Funkcja zamyka połączenie.
+  //! Funkcja zamyka połączenie (dla SSL - po wysłaniu close_notify i oczekiwaniu na odpowiedź, ograniczonym w czasie).
   virtual void close()=0;
+  //! Funkcja zamyka połączenie natychmiast (dla SSL - bez wysyłania close_notify, np. dla porzucanych połączeń).
+  virtual void abort()=0;
   //! Sprawdza, czy połaczenie jest nadal otwarte.
   virtual bool is_open() const=0;
   //! Zwraca ilość bajtów oczekujących na odczyt.
@@ -78,14 +118,122 @@ public:
   //! Zapisuje dane do połączenia
   //! @param buffer Bufor z danymi do zapisu (Uwaga: rozmiar musi być ustawiony przed użyciem!).
   //! @param handler Funkcja do obsługi zapisu.
-  virtual void async_write_some(buffer_t& buffer,const handler_t &handler)=0;
+  virtual void async_write_some(buffer_t& buffer,handler_t handler)=0;
   //! Odczytuje dane z połączenia
   //! @param buffer Bufor dla danych z odczytu (Uwaga: rozmiar musi być ustawiony przed użyciem!).
   //! @param handler Funkcja do obsługi odczytu.
-  virtual void async_read_some(buffer_t& buffer,const handler_t &handler)=0;
+  virtual void async_read_some(buffer_t& buffer,handler_t handler)=0;
+  //! Zapisuje dane z wielu buforów do połączenia (writev/sendmsg, dla SSL - jeden rekord TLS z połączonych buforów).
+  //! @param buffers Lista buforów z danymi do zapisu (Uwaga: rozmiary muszą być ustawione przed użyciem!).
+  //! @param handler Funkcja do obsługi zapisu (otrzymuje łączną liczbę zapisanych bajtów).
+  virtual void async_write_some(buffers_t& buffers,handler_t handler)=0;
+  //! Odczytuje dane z połączenia do wielu buforów (readv/recvmsg, dla SSL - do pierwszego niepustego bufora).
+  //! @param buffers Lista buforów dla danych z odczytu (Uwaga: rozmiary muszą być ustawione przed użyciem!).
+  //! @param handler Funkcja do obsługi odczytu (otrzymuje łączną liczbę odczytanych bajtów).
+  virtual void async_read_some(buffers_t& buffers,handler_t handler)=0;
+  //! Zapisuje wszystkie dane z bufora do połączenia (jedna złożona operacja ASIO - bez ponownego kolejkowania po częściowym zapisie).
+  //! @param buffer Bufor z danymi do zapisu.
+  //! @param handler Funkcja do obsługi zapisu (wywoływana po zapisaniu wszystkich danych lub w przypadku błędu).
+  virtual void async_write_all(buffer_t& buffer,handler_t handler)=0;
+  //! Odczytuje z połączenia dokładnie tyle bajtów, ile wynosi rozmiar bufora (jedna złożona operacja ASIO).
+  //! @param buffer Bufor dla danych z odczytu (Uwaga: rozmiar musi być ustawiony przed użyciem!).
+  //! @param handler Funkcja do obsługi odczytu (wywoływana po wypełnieniu bufora lub w przypadku błędu).
+  virtual void async_read_exact(buffer_t& buffer,handler_t handler)=0;
+  //! Odczytuje dane z połączenia, dopóki w buforze nie pojawi się ogranicznik (jedna złożona operacja ASIO).
+  //! Dane są dopisywane na końcu bufora, za ogranicznikiem w buforze mogą znajdować się dalsze dane.
+  //! @param buffer Bufor dla danych z odczytu.
+  //! @param delimiter Ogranicznik.
+  //! @param handler Funkcja do obsługi odczytu (otrzymuje liczbę bajtów w buforze do końca ogranicznika włącznie).
+  //! @param max Maksymalny rozmiar bufora (po jego przekroczeniu operacja kończy się błędem).
+  virtual void async_read_until(buffer_t& buffer,const std::string & delimiter,handler_t handler,std::size_t max=0x10000)=0;
+  //! Zapisuje dane do połączenia z dowolnego miejsca w pamięci - bez kopiowania (np. ::asio::buffer(std::string), std::span, mmap).
+  //! @param view Widok danych do zapisu (dane muszą istnieć do zakończenia operacji).
+  //! @param handler Funkcja do obsługi zapisu.
+  virtual void async_write_some(const ::asio::const_buffer & view,handler_t handler)=0;
+  //! Odczytuje dane z połączenia do dowolnego miejsca w pamięci.
+  //! @param view Widok obszaru dla danych z odczytu (obszar musi istnieć do zakończenia operacji).
+  //! @param handler Funkcja do obsługi odczytu.
+  virtual void async_read_some(const ::asio::mutable_buffer & view,handler_t handler)=0;
+  //! Zapisuje wszystkie dane do połączenia z dowolnego miejsca w pamięci - bez kopiowania (patrz async_write_all(buffer_t&,handler_t)).
+  //! @param view Widok danych do zapisu (dane muszą istnieć do zakończenia operacji).
+  //! @param handler Funkcja do obsługi zapisu.
+  virtual void async_write_all(const ::asio::const_buffer & view,handler_t handler)=0;
+  //! Odczytuje dokładnie view.size() bajtów do dowolnego miejsca w pamięci (patrz async_read_exact(buffer_t&,handler_t)).
+  //! @param view Widok obszaru dla danych z odczytu (obszar musi istnieć do zakończenia operacji).
+  //! @param handler Funkcja do obsługi odczytu.
+  virtual void async_read_exact(const ::asio::mutable_buffer & view,handler_t handler)=0;
+  //! Zapisuje dane współdzielone (np. std::shared_ptr<const std::string>) - wskaźnik jest przechowywany do zakończenia operacji.
+  //! @param data Wskaźnik do danych (dowolny typ obsługiwany przez ::asio::buffer()).
+  //! @param handler Funkcja do obsługi zapisu.
+  template<class Data> void async_write_some(const std::shared_ptr<Data> & data,handler_t handler){
+    async_write_some(::asio::const_buffer(::asio::buffer(*data)),[data,handler=std::move(handler)](const ict::asio::error_code_t& ec,std::size_t s) mutable {
+      handler(ec,s);
+    });
+  }
+  //! Zapisuje wszystkie dane współdzielone (np. std::shared_ptr<const std::string>) - wskaźnik jest przechowywany do zakończenia operacji.
+  //! @param data Wskaźnik do danych (dowolny typ obsługiwany przez ::asio::buffer()).
+  //! @param handler Funkcja do obsługi zapisu.
+  template<class Data> void async_write_all(const std::shared_ptr<Data> & data,handler_t handler){
+    async_write_all(::asio::const_buffer(::asio::buffer(*data)),[data,handler=std::move(handler)](const ict::asio::error_code_t& ec,std::size_t s) mutable {
+      handler(ec,s);
+    });
+  }
+  //! Wysyła dane z pliku do połączenia (dla TCP i gniazd lokalnych bez szyfrowania - sendfile(), bez kopiowania danych
+  //! przez przestrzeń użytkownika; w pozostałych przypadkach - odczyt pliku do bufora i zapis).
+  //! @param fd Deskryptor pliku (musi pozostać otwarty do zakończenia operacji).
+  //! @param offset Pozycja w pliku, od której zaczynają się dane.
+  //! @param length Ilość danych do wysłania.
+  //! @param handler Funkcja do obsługi zapisu (wywoływana po wysłaniu wszystkich danych lub w przypadku błędu).
+  virtual void async_send_file(int fd,std::size_t offset,std::size_t length,handler_t handler)=0;
+  //! Dodaje dane do kolejki zapisu połączenia - dane są zapisywane w kolejności dodania (zapis wektorowy wielu wiadomości naraz).
+  //! Nie należy wywoływać innych funkcji zapisu, dopóki kolejka nie jest pusta.
+  //! @param owner Właściciel danych (przechowywany do zakończenia zapisu).
+  //! @param view Widok danych do zapisu.
+  //! @param handler Funkcja do obsługi zapisu (może być pusta).
+  virtual void enqueue(const std::shared_ptr<const void> & owner,const ::asio::const_buffer & view,handler_t handler=handler_t())=0;
+  //! Dodaje bufor do kolejki zapisu połączenia (bufor jest przenoszony do kolejki).
+  //! @param data Dane do zapisu.
+  //! @param handler Funkcja do obsługi zapisu (może być pusta).
+  void enqueue(buffer_t && data,handler_t handler=handler_t()){
+    const std::shared_ptr<const buffer_t> owner(std::make_shared<const buffer_t>(std::move(data)));
+    enqueue(owner,::asio::const_buffer(owner->data(),owner->size()),std::move(handler));
+  }
+  //! Dodaje dane współdzielone (np. std::shared_ptr<const std::string>) do kolejki zapisu połączenia - bez kopiowania.
+  //! @param data Wskaźnik do danych (dowolny typ obsługiwany przez ::asio::buffer()).
+  //! @param handler Funkcja do obsługi zapisu (może być pusta).
+  template<class Data> void enqueue(const std::shared_ptr<Data> & data,handler_t handler=handler_t()){
+    enqueue(std::shared_ptr<const void>(data),::asio::const_buffer(::asio::buffer(*data)),std::move(handler));
+  }
+  //! Ustawia progi kolejki zapisu - po przekroczeniu progu górnego wywoływana jest funkcja z parametrem true (wstrzymaj),
+  //! po spadku do progu dolnego - z parametrem false (wznów).
+  //! @param low Próg dolny (w bajtach).
+  //! @param high Próg górny (w bajtach, 0 - bez progów).
+  //! @param handler Funkcja wywoływana w ramach ::asio::strand połączenia.
+  virtual void set_watermarks(std::size_t low,std::size_t high,const watermark_handler_t & handler)=0;
+  //! Zwraca ilość danych w kolejce zapisu (w bajtach).
+  virtual std::size_t queued() const=0;
+  //! Uzgadnia połączenie SSL (dla połączeń bez szyfrowania funkcja do obsługi jest wywoływana od razu).
+  //! Operacje zlecone w trakcie uzgadniania są wykonywane po jego zakończeniu, a po błędzie uzgadniania kończą się tym błędem.
+  //! Wynik jest zapisywany w metadanych połączenia (socket_resumed - czy sesja TLS została wznowiona).
+  //! @param server Informacja, czy połączenie jest po stronie serwera, czy klienta.
+  //! @param session Klucz sesji TLS w pamięci podręcznej (tylko klient, np. host:port:SNI; pusty - bez wznawiania sesji).
+  //! @param timeout Maksymalny czas uzgadniania (po jego przekroczeniu - błąd ETIMEDOUT).
+  //! @param handler Funkcja do obsługi uzgodnienia połączenia.
+  virtual void async_handshake(bool server,const std::string & session,const std::chrono::milliseconds & timeout,error_handler_t handler)=0;
   //! Dodaje zadanie do wykonania w ramach ::asio::strand
   //! @param handler Zadanie do wykonania.
-  virtual void post(const asio_handler_t &handler)=0;
+  virtual void post(asio_handler_t handler)=0;
+  //! Ustawia priorytet zadań połączenia (patrz ioServicePost()) - dotyczy zadań dodawanych do ::asio::strand
+  //! oraz wywołań funkcji do obsługi zapisu i odczytu.
+  //! @param priority Priorytet.
+  virtual void set_priority(priority_t priority)=0;
+  //! Ustawia opcje gniazda połączenia (np. TCP_NODELAY, SO_SNDBUF, keepalive).
+  //! @param options Opcje gniazda (nieustawione opcje nie są zmieniane).
+  virtual void set_options(const socket_options_t & options)=0;
+  virtual void set_options(const socket_options_t & options,error_code_t& ec)=0;
+  //! Ustawia maksymalny czas zamykania połączenia SSL (wymiany close_notify, patrz close()) - domyślnie 2 s.
+  //! @param timeout Maksymalny czas (po jego przekroczeniu gniazdo jest zamykane).
+  virtual void set_shutdown_timeout(const std::chrono::milliseconds & timeout)=0;
   //! Zwraca nazwę serwera (SNI).
   //! @returns Nazwa serwera (SNI).
   virtual const std::string & getSNI() {static const std::string nic;return(nic);};
@@ -97,6 +245,23 @@ typedef std::shared_ptr<interface> interface_ptr;
 //! @param ec Kod błędu
 //! @param interface  Wskaźnik do interfejsu do obsługi połączeń.
 typedef std::function<void(const error_code_t&,interface_ptr)> connection_handler_t;
+//! Funkcja wyboru kontekstu SSL na podstawie nazwy serwera (SNI).
+//! @param sni Nazwa serwera odebrana od klienta.
+//! @returns Kontekst SSL dla tej nazwy (NULL - bez zmiany kontekstu).
+typedef std::function<context_ptr(const std::string & sni)> context_selector_t;
+//! Ustawia funkcję wyboru kontekstu SSL dla połączeń serwera - jeden serwer może obsługiwać wiele certyfikatów
+//! (może być zmieniona w dowolnym momencie - trwające uzgadnianie połączenia używa poprzedniej funkcji).
+//! @param context Kontekst SSL serwera (przekazany do connector::get()).
+//! @param selector Funkcja wyboru kontekstu.
+void setContextSelector(const context_ptr & context,const context_selector_t & selector);
+//! Funkcja wykonywana dla każdego z połączeń (patrz post()).
+//! @param ptr Wskaźnik do interfejsu do obsługi połączenia.
+typedef std::function<void(const interface_ptr & ptr)> batch_handler_t;
+//! Wykonuje funkcję w ramach ::asio::strand każdego z połączeń - zadania są dodawane jedną operacją
+//! dla każdego ::asio::io_service (patrz ioServicePost(std::vector<asio_handler_t>)).
+//! @param connections Lista połączeń.
+//! @param handler Funkcja do wykonania dla każdego z połączeń.
+void post(const std::vector<interface_ptr> & connections,const batch_handler_t & handler);
 //============================================
 }}}
 //===========================================
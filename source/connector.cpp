@@ -39,6 +39,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "asio.hpp"
 #include "connector.hpp"
 #include "service.h"
+#include "prefork.hpp"
 #include "resolver.h"
 #include "connection.h"
 #include "connection-string.h"
@@ -76,12 +77,25 @@ void interface::async_connection(const ict::asio::connection::message_handler_t
 //============================================
 namespace server {
 //============================================
+//! Ustawia opcję SO_REUSEPORT dla serwera TCP w procesie roboczym (patrz ioPrefork()).
+static void setReusePort(::asio::ip::tcp::acceptor & a){
+#ifdef SO_REUSEPORT
+  if (0<=ioPreforkWorker()){
+    typedef ::asio::detail::socket_option::boolean<SOL_SOCKET,SO_REUSEPORT> reuse_port_t;
+    ::asio::error_code ec;
+    a.set_option(reuse_port_t(true),ec);
+  }
+#endif
+}
+static void setReusePort(::asio::local::stream_protocol::acceptor & a){
+}
 template<class Endpoint,class Acceptor> bool doBindOne(const Endpoint & ep,Acceptor & a,error_code_t & ec){
   a.close();
   a.open(ep.protocol(),ec);
   if (ec) {
     return(false);
   } else {
+    setReusePort(a);
     a.bind(ep,ec);
     if (ec) {
       return(false);
@@ -103,18 +117,77 @@ template<class Endpoints,class Acceptor> bool doBind(const Endpoints & eps,Accep
 //============================================
 }
 //============================================
+//! Ustawia opcję SO_BUSY_POLL dla gniazda TCP (patrz io_config_t::busy_poll).
+static void setBusyPoll(::asio::ip::tcp::socket & socket){
+#ifdef SO_BUSY_POLL
+  if (ioConfig().busy_poll){
+    typedef ::asio::detail::socket_option::integer<SOL_SOCKET,SO_BUSY_POLL> busy_poll_t;
+    ::asio::error_code ec;
+    socket.set_option(busy_poll_t(ioConfig().busy_poll),ec);
+  }
+#endif
+}
+static void setBusyPoll(::asio::local::stream_protocol::socket & socket){
+}
+//============================================
 template <class Socket> class BasicConnector: public interface {
 protected:
+  //! Metadane konektora przekazywane do połączeń (patrz setup()).
+  std::shared_ptr<const ict::asio::map_info_t> shared;
   bool ready=false;
   bool error=false;
   ict::asio::context_ptr context;
-  ::asio::io_service::strand strand;
+  ict::asio::strand_t strand;
 public:
   BasicConnector(const ict::asio::context_ptr & c):context(c),strand(ict::asio::ioService()){
+    if (c) ict::asio::connection::setServerNameCallback(c);
   }
   bool is_error() const{
     return(error);
   }
+  //! Przygotowuje nowe połączenie (patrz setup()) i uzgadnia połączenie SSL - klient wznawia sesje TLS z pamięci podręcznej
+  //! (klucz: host:port:SNI lub ścieżka:SNI).
+  //! Serwer przekazuje połączenie od razu (uzgadnianie nie wstrzymuje przyjmowania kolejnych połączeń) - błąd uzgadniania
+  //! zamyka połączenie i kończy jego operacje, klient przekazuje połączenie po uzgodnieniu.
+  //! @param ptr Nowe połączenie.
+  //! @param handler Funkcja do obsługi nowego połączenia.
+  void handshake(const ict::asio::connection::interface_ptr & ptr,const ict::asio::connection::connection_handler_t & handler){
+    setup(ptr);
+    if (!context){
+      handler(error_code_t(),ptr);
+      return;
+    }
+    if (interface::info.at(_connector_server_)==_1_){
+      ptr->async_handshake(true,_empty_,interface::handshake_timeout,[](const error_code_t& ec){});
+      handler(error_code_t(),ptr);
+      return;
+    }
+    const std::string key((
+      (interface::info.at(_connector_type_)==_tcp_)?
+        (interface::info.at(_connector_host_)+":"+interface::info.at(_connector_port_)):
+        interface::info.at(_connector_path_)
+    )+":"+interface::info.at(_connector_sni_));
+    ptr->async_handshake(false,key,interface::handshake_timeout,[ptr,handler](const error_code_t& ec){
+      if (ec){
+        ict::asio::connection::interface_ptr empty;
+        handler(ec,empty);
+      } else {
+        handler(ec,ptr);
+      }
+    });
+  }
+  //! Przekazuje do nowego połączenia metadane, priorytet oraz opcje gniazda konektora.
+  //! @param ptr Nowe połączenie.
+  void setup(const ict::asio::connection::interface_ptr & ptr){
+    //Metadane konektora są współdzielone przez jego połączenia - kopia jest tworzona ponownie tylko po zmianie interface::info.
+    if ((!shared)||(*shared!=interface::info)) shared=std::make_shared<const ict::asio::map_info_t>(interface::info);
+    ptr->info.connector=shared;
+    if (interface::priority) ptr->set_priority(*interface::priority);
+    ptr->set_shutdown_timeout(interface::shutdown_timeout);
+    //Błąd ustawienia opcji nie zamyka połączenia.
+    error_code_t ec;
+    ptr->set_options(interface::options,ec);
+  }
 };
 template <class Socket,class Acceptor> class ServerConnector: public BasicConnector<Socket> {
 private:
@@ -123,6 +196,7 @@ private:
 private:
   void accept(const ict::asio::connection::connection_handler_t & handler){
     auto self(interface::enable_shared_t::shared_from_this());
+    if (1<ict::asio::ioServiceSize()) s=Socket(ict::asio::ioServiceNext());
     a.async_accept(
       s,
       [this,self,handler](error_code_t ec){
@@ -130,15 +204,13 @@ private:
           ict::asio::connection::interface_ptr empty;
           handler(ec,empty);
         } else {
+          setBusyPoll(s);
           ict::asio::connection::interface_ptr ptr(
             BasicConnector<Socket>::context?
               ict::asio::connection::get(s,BasicConnector<Socket>::context,interface::info.at(_connector_sni_)):
               ict::asio::connection::get(s)
           );
-          for (ict::asio::map_info_t::const_iterator it=interface::info.begin();it!=interface::info.end();++it){
-            ptr->info[it->first]=it->second;
-          }
-          handler(ec,ptr);
+          BasicConnector<Socket>::handshake(ptr,handler);
         }
       }
     );
@@ -262,15 +334,13 @@ private:
             i++;
             connect(handler);
           } else {
+            setBusyPoll(s);
             ict::asio::connection::interface_ptr ptr(
               BasicConnector<Socket>::context?
                 ict::asio::connection::get(s,BasicConnector<Socket>::context,interface::info.at(_connector_sni_)):
                 ict::asio::connection::get(s)
             );
-            for (ict::asio::map_info_t::const_iterator it=interface::info.begin();it!=interface::info.end();++it){
-              ptr->info[it->first]=it->second;
-            }
-            handler(ec,ptr);
+            BasicConnector<Socket>::handshake(ptr,handler);
           }
         }
       );
@@ -294,6 +364,7 @@ private:
         } else {
           e=ep;
           i=0;
+          if (1<ict::asio::ioServiceSize()) s=Socket(ict::asio::ioServiceNext());
           connect(handler);
         }
       }
@@ -310,13 +381,16 @@ private:
         } else {
           e=ep;
           i=0;
+          if (1<ict::asio::ioServiceSize()) s=Socket(ict::asio::ioServiceNext());
           connect(handler);
         }
       }
     );
   }
 public:
-  ClientConnector(const ict::asio::context_ptr & c):BasicConnector<Socket>(c),s(ict::asio::ioService()),t(ict::asio::ioService()){}
+  ClientConnector(const ict::asio::context_ptr & c):BasicConnector<Socket>(c),s(ict::asio::ioService()),t(ict::asio::ioService()){
+    if (c) ict::asio::connection::setSessionCache(c);
+  }
   ~ClientConnector(){}
   void close(){
     auto self(interface::enable_shared_t::shared_from_this());
@@ -350,7 +424,7 @@ public:
   }
 };
 //============================================
-interface_ptr get(const std::string & host,const std::string & port,bool server,const ict::asio::context_ptr & context,const std::string & setSNI){
+interface_ptr get(const std::string & host,const std::string & port,bool server,const ict::asio::context_ptr & context,const std::string & setSNI,const socket_options_t & options){
   interface_ptr ptr;
   if (server){
     ptr=std::make_shared<ServerConnector<::asio::ip::tcp::socket,::asio::ip::tcp::acceptor>>(context);
@@ -363,9 +437,10 @@ interface_ptr get(const std::string & host,const std::string & port,bool server,
   ptr->info[_connector_path_]=_empty_;
   ptr->info[_connector_server_]=server?_1_:_0_;
   ptr->info[_connector_sni_]=setSNI;
+  ptr->set_options(options);
   return(ptr);
 }
-interface_ptr get(const std::string & path,bool server,const ict::asio::context_ptr & context,const std::string & setSNI){
+interface_ptr get(const std::string & path,bool server,const ict::asio::context_ptr & context,const std::string & setSNI,const socket_options_t & options){
   interface_ptr ptr;
   if (server){
     ptr=std::make_shared<ServerConnector<::asio::local::stream_protocol::socket,::asio::local::stream_protocol::acceptor>>(context);
@@ -378,6 +453,7 @@ interface_ptr get(const std::string & path,bool server,const ict::asio::context_
   ptr->info[_connector_path_]=path;
   ptr->info[_connector_server_]=server?_1_:_0_;
   ptr->info[_connector_sni_]=setSNI;
+  ptr->set_options(options);
   return(ptr);
 }
 //============================================
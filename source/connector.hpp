@@ -36,6 +36,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef _ASIO_CONNECTOR_HEADER
 #define _ASIO_CONNECTOR_HEADER
 //============================================
+#include <chrono>
+#include <optional>
 #include "types.hpp"
 #include "connection.hpp"
 #include "connection-string.hpp"
@@ -44,6 +46,15 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 namespace ict { namespace asio { namespace connector {
 //===========================================
 class interface : public std::enable_shared_from_this<interface>{
+protected:
+    //! Priorytet nowych połączeń.
+    std::optional<priority_t> priority;
+    //! Opcje gniazd nowych połączeń.
+    socket_options_t options;
+    //! Maksymalny czas uzgadniania połączenia SSL.
+    std::chrono::milliseconds handshake_timeout{10000};
+    //! Maksymalny czas zamykania połączenia SSL (wymiany close_notify).
+    std::chrono::milliseconds shutdown_timeout{2000};
 public:
     typedef  std::enable_shared_from_this<interface> enable_shared_t;
     map_info_t info;
@@ -62,6 +73,26 @@ public:
     //! Obsługuje nowe połączenie.
     //! @param handler Funkcja do obsługi nowego połaczenia.
     virtual void async_connection(const ict::asio::connection::connection_handler_t &handler)=0;
+    //! Ustawia priorytet nowych połączeń (patrz connection::interface::set_priority()) - należy wywołać przed async_connection().
+    //! @param p Priorytet.
+    void set_priority(priority_t p){
+      priority=p;
+    }
+    //! Ustawia opcje gniazd nowych połączeń (patrz connection::interface::set_options()) - należy wywołać przed async_connection().
+    //! @param o Opcje gniazd.
+    void set_options(const socket_options_t & o){
+      options=o;
+    }
+    //! Ustawia maksymalny czas uzgadniania połączenia SSL (po jego przekroczeniu połączenie jest zamykane z błędem ETIMEDOUT).
+    //! @param t Maksymalny czas.
+    void set_handshake_timeout(const std::chrono::milliseconds & t){
+      handshake_timeout=t;
+    }
+    //! Ustawia maksymalny czas zamykania połączenia SSL nowych połączeń (patrz connection::interface::set_shutdown_timeout()) - należy wywołać przed async_connection().
+    //! @param t Maksymalny czas.
+    void set_shutdown_timeout(const std::chrono::milliseconds & t){
+      shutdown_timeout=t;
+    }
     void async_connection(const ict::asio::connection::string_handler_t &handler);
     void async_connection(const ict::asio::connection::string2_handler_t &handler);
     void async_connection(const ict::asio::connection::message_handler_t &handler);
@@ -76,13 +107,15 @@ typedef std::shared_ptr<interface> interface_ptr;
 //! @param server Informacja, czy to ma być konektor typu serwer, czy typu klient.
 //! @param context Informacja, czy połączenia mają być szyfrowane, czy nie (jeśli tak, to trzeba ustawić kontekst).
 //! @param setSNI Ustawnia SNI dla szyfrowanych połączeń wychodzących (klient).
-interface_ptr get(const std::string & host,const std::string & port,bool server=true,const ict::asio::context_ptr & context=NULL,const std::string & setSNI="");
+//! @param options Opcje gniazd nowych połączeń (np. TCP_NODELAY).
+interface_ptr get(const std::string & host,const std::string & port,bool server=true,const ict::asio::context_ptr & context=NULL,const std::string & setSNI="",const socket_options_t & options=socket_options_t());
 //! Funkcja do tworzenia konektorów dla gniazd lokalnych.
 //! @param path Ścieżka, na której ma się bindować (jako serwer), lub do której ma się łączyć (jako klient).
 //! @param server Informacja, czy to ma być  konektor typu serwer, czy typu klient.
 //! @param context Informacja, czy połączenia mają być szyfrowane, czy nie (jeśli tak, to trzeba ustawić kontekst).
 //! @param setSNI Ustawnia SNI dla szyfrowanych połączeń wychodzących (klient).
-interface_ptr get(const std::string & path,bool server=true,const ict::asio::context_ptr & context=NULL,const std::string & setSNI="");
+//! @param options Opcje gniazd nowych połączeń (opcje TCP są ignorowane).
+interface_ptr get(const std::string & path,bool server=true,const ict::asio::context_ptr & context=NULL,const std::string & setSNI="",const socket_options_t & options=socket_options_t());
 //============================================
 }}}
 //===========================================
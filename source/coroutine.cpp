@@ -0,0 +1,279 @@
+//! @file
+//! @brief ASIO coroutine module - Source file.
+//! @author Mariusz Ornowski (mariusz.ornowski@ict-project.pl)
+//! @date 2020-2022
+//! @copyright ICT-Project Mariusz Ornowski (ict-project.pl)
+/* **************************************************************
+Copyright (c) 2020-2022, ICT-Project Mariusz Ornowski (ict-project.pl)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1. Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of the ICT-Project Mariusz Ornowski nor the names
+of its contributors may be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**************************************************************/
+//============================================
+#include "coroutine.hpp"
+//============================================
+namespace ict { namespace asio { namespace coroutine {
+//============================================
+#ifdef ASIO_HAS_CO_AWAIT
+::asio::awaitable<void> read_headers(connection::message_ptr ptr,ict::asio::message::headers_t & headers){
+  do {
+    headers.emplace_back();
+    co_await connection::async_read_header(ptr,headers.back());
+  } while (!(headers.back().name.empty()||(headers.back().name==":")));
+}
+::asio::awaitable<void> write_headers(connection::message_ptr ptr,ict::asio::message::headers_t & headers){
+  while (!headers.empty()){
+    co_await connection::async_write_header(ptr,headers.front());
+    headers.erase(headers.begin());
+  }
+}
+::asio::awaitable<void> read_request_headers(connection::message_ptr ptr,ict::asio::message::request_headers_t & request){
+  co_await connection::async_read_request(ptr,request.request);
+  co_await read_headers(ptr,request.headers);
+}
+::asio::awaitable<void> write_request_headers(connection::message_ptr ptr,ict::asio::message::request_headers_t & request){
+  co_await connection::async_write_request(ptr,request.request);
+  co_await write_headers(ptr,request.headers);
+}
+::asio::awaitable<void> read_response_headers(connection::message_ptr ptr,ict::asio::message::response_headers_t & response){
+  co_await connection::async_read_response(ptr,response.response);
+  co_await read_headers(ptr,response.headers);
+}
+::asio::awaitable<void> write_response_headers(connection::message_ptr ptr,ict::asio::message::response_headers_t & response){
+  co_await connection::async_write_response(ptr,response.response);
+  co_await write_headers(ptr,response.headers);
+}
+#endif
+//============================================
+}}}
+//============================================
+#ifdef ENABLE_TESTING
+#include "test.hpp"
+#include <future>
+#include <asio/co_spawn.hpp>
+#include "service.h"
+#include "asio.hpp"
+#include "connector.hpp"
+#include "connection-message.h"
+#ifdef ASIO_HAS_CO_AWAIT
+#include <cstdio>
+#include <functional>
+#include <asio/local/stream_protocol.hpp>
+#include <asio/local/connect_pair.hpp>
+static ::asio::awaitable<int> test__server(ict::asio::connection::interface_ptr ptr){
+  ict::asio::connection::interface::buffer_t buffer(4);
+  std::size_t s(co_await ict::asio::connection::async_read_some(ptr,buffer));
+  if ((s!=4)||(buffer.at(0)!='a')) co_return(-1);
+  ict::asio::connection::message_ptr message(ict::asio::connection::getMessage(ptr));
+  ict::asio::message::request_headers_t request;
+  co_await ict::asio::connection::async_read_request_headers(message,request);
+  if ((request.request.method!="POST")||(request.headers.size()!=2)||(request.headers.at(0).value!="example.com")) co_return(-2);
+  ict::asio::message::response_headers_t response;
+  response.response={"HTTP/1.1","200","OK"};
+  response.headers={{"Server","ict"},{":",""}};
+  co_await ict::asio::connection::async_write_response_headers(message,response);
+  //Po zamknięciu połączenia przez klienta odczyt kończy się wyjątkiem.
+  try {
+    co_await ict::asio::connection::async_read_some(ptr,buffer);
+  } catch (const std::system_error & e) {
+    co_return(0);
+  }
+  co_return(-3);
+}
+static ::asio::awaitable<int> test__client(ict::asio::connection::interface_ptr ptr){
+  ict::asio::lock::interface_ptr lock(co_await ict::asio::lock::async_get("coroutine"));
+  if (!lock) co_return(-10);
+  ict::asio::timer::interface_ptr timer(ict::asio::timer::get(std::chrono::milliseconds(10)));
+  const auto start(std::chrono::steady_clock::now());
+  co_await ict::asio::timer::async_wait(timer);
+  if ((std::chrono::steady_clock::now()-start)<std::chrono::milliseconds(10)) co_return(-11);
+  ict::asio::connection::interface::buffer_t buffer={'a','b','c','d'};
+  std::size_t s(co_await ict::asio::connection::async_write_some(ptr,buffer));
+  if (s!=4) co_return(-12);
+  ict::asio::connection::message_ptr message(ict::asio::connection::getMessage(ptr));
+  ict::asio::message::request_headers_t request;
+  request.request={"POST","/","HTTP/1.1"};
+  request.headers={{"Host","example.com"},{":",""}};
+  co_await ict::asio::connection::async_write_request_headers(message,request);
+  ict::asio::message::response_headers_t response;
+  co_await ict::asio::connection::async_read_response_headers(message,response);
+  if ((response.response.code!="200")||(response.headers.size()!=2)) co_return(-13);
+  ptr->close();
+  co_return(0);
+}
+static ::asio::awaitable<int> test__operations(ict::asio::connection::interface_ptr writer,ict::asio::connection::interface_ptr reader){
+  ict::asio::connection::interface::buffer_t first={'a','b'},second={'c','d','\n'};
+  ict::asio::connection::interface::buffers_t out={&first,&second};
+  if ((co_await ict::asio::connection::async_write_some(writer,out))!=5) co_return(-1);
+  ict::asio::connection::interface::buffer_t line;
+  if ((co_await ict::asio::connection::async_read_until(reader,line,"\n"))!=5) co_return(-2);
+  if (std::string(line.begin(),line.end())!="abcd\n") co_return(-3);
+  static const std::string text("view!");
+  char view[5];
+  co_await ict::asio::connection::async_write_all(writer,::asio::buffer(text));
+  if ((co_await ict::asio::connection::async_read_exact(reader,::asio::buffer(view)))!=5) co_return(-4);
+  if (std::string(view,5)!=text) co_return(-5);
+  std::FILE * file(std::tmpfile());
+  if (!file) co_return(-6);
+  std::fputs("file",file);
+  std::fflush(file);
+  ict::asio::connection::interface::buffer_t data(4);
+  const std::size_t sent(co_await ict::asio::connection::async_send_file(writer,fileno(file),0,4));
+  std::fclose(file);
+  if (sent!=4) co_return(-7);
+  co_await ict::asio::connection::async_read_exact(reader,data);
+  if (std::string(data.begin(),data.end())!="file") co_return(-8);
+  const std::shared_ptr<const std::string> queued(std::make_shared<const std::string>("queued"));
+  co_await ict::asio::connection::async_enqueue(writer,queued,::asio::buffer(*queued));
+  data.resize(6);
+  co_await ict::asio::connection::async_read_exact(reader,data);
+  if (std::string(data.begin(),data.end())!=*queued) co_return(-9);
+  co_return(0);
+}
+static const std::size_t _test_cost_count_(10000);
+static ::asio::awaitable<int> test__cost(ict::asio::connection::interface_ptr writer,ict::asio::connection::interface_ptr reader){
+  ict::asio::connection::interface::buffer_t out={'x'},in(1);
+  for (std::size_t k=0;k<_test_cost_count_;k++){
+    co_await ict::asio::connection::async_write_all(writer,out);
+    co_await ict::asio::connection::async_read_exact(reader,in);
+  }
+  co_return(0);
+}
+static void test__cost_handler(ict::asio::connection::interface_ptr writer,ict::asio::connection::interface_ptr reader,std::size_t k,const std::function<void(int)> & done){
+  static ict::asio::connection::interface::buffer_t out={'x'},in(1);
+  if (k==_test_cost_count_){
+    done(0);
+    return;
+  }
+  writer->async_write_all(out,[writer,reader,k,done](const ict::asio::error_code_t& ec,std::size_t){
+    if (ec) {
+      done(-1);
+      return;
+    }
+    reader->async_read_exact(in,[writer,reader,k,done](const ict::asio::error_code_t& ec,std::size_t){
+      if (ec) {
+        done(-2);
+        return;
+      }
+      test__cost_handler(writer,reader,k+1,done);
+    });
+  });
+}
+#endif
+REGISTER_TEST(coroutine,tc1){
+#ifdef ASIO_HAS_CO_AWAIT
+  std::promise<int> server,client;
+  std::future<int> s(server.get_future());
+  std::future<int> c(client.get_future());
+  srand(time(NULL));
+  const std::string port("302"+std::to_string(rand()%90+10));
+  ict::asio::ioRun();
+  ict::asio::connector::interface_ptr s1(ict::asio::connector::get("localhost",port,true));
+  ict::asio::connector::interface_ptr c1(ict::asio::connector::get("localhost",port,false));
+  s1->async_connection([&](const ict::asio::error_code_t& ec,ict::asio::connection::interface_ptr ptr){
+    if (ec||!ptr){
+      server.set_value(-100);
+      return;
+    }
+    ::asio::co_spawn(ict::asio::ioService(),test__server(ptr),[&](std::exception_ptr e,int r){
+      server.set_value(e?-101:r);
+    });
+  });
+  usleep(5000);
+  c1->async_connection([&](const ict::asio::error_code_t& ec,ict::asio::connection::interface_ptr ptr){
+    if (ec||!ptr){
+      client.set_value(-200);
+      return;
+    }
+    ::asio::co_spawn(ict::asio::ioService(),test__client(ptr),[&](std::exception_ptr e,int r){
+      client.set_value(e?-201:r);
+    });
+  });
+  int r(0);
+  if (c.wait_for(std::chrono::seconds(60))!=std::future_status::ready) r=-300;
+  else if (c.get()) r=-301;
+  else if (s.wait_for(std::chrono::seconds(60))!=std::future_status::ready) r=-302;
+  else r=s.get();
+  s1->close();
+  usleep(10000);
+  ict::asio::ioStop();
+  ict::asio::ioJoin();
+  return(r);
+#else
+  std::cout<<"Coroutines (co_await) are not supported"<<std::endl;
+  return(0);
+#endif
+}
+REGISTER_TEST(coroutine,tc2){
+#ifdef ASIO_HAS_CO_AWAIT
+  ::asio::local::stream_protocol::socket a(ict::asio::ioService()),b(ict::asio::ioService());
+  ::asio::local::connect_pair(a,b);
+  ict::asio::connection::interface_ptr writer(ict::asio::connection::get(a));
+  ict::asio::connection::interface_ptr reader(ict::asio::connection::get(b));
+  ict::asio::ioRun();
+  auto run=[](const std::function<void(const std::function<void(int)>&)> & start){
+    std::promise<int> result;
+    std::future<int> f(result.get_future());
+    start([&result](int r){result.set_value(r);});
+    return((f.wait_for(std::chrono::seconds(60))==std::future_status::ready)?f.get():-100);
+  };
+  int r(run([&](const std::function<void(int)> & done){
+    ::asio::co_spawn(ict::asio::ioService(),test__operations(writer,reader),[done](std::exception_ptr e,int v){
+      done(e?-101:v);
+    });
+  }));
+  if (!r){
+    //Koszt adaptera: ta sama sekwencja operacji z funkcjami zwrotnymi oraz z co_await.
+    const auto start(std::chrono::steady_clock::now());
+    r=run([&](const std::function<void(int)> & done){
+      test__cost_handler(writer,reader,0,done);
+    });
+    const auto middle(std::chrono::steady_clock::now());
+    if (!r) r=run([&](const std::function<void(int)> & done){
+      ::asio::co_spawn(ict::asio::ioService(),test__cost(writer,reader),[done](std::exception_ptr e,int v){
+        done(e?-102:v);
+      });
+    });
+    const auto stop(std::chrono::steady_clock::now());
+    if (!r){
+      const std::size_t ops(2*_test_cost_count_);
+      const std::size_t handler(std::chrono::duration_cast<std::chrono::nanoseconds>(middle-start).count()/ops);
+      const std::size_t awaitable(std::chrono::duration_cast<std::chrono::nanoseconds>(stop-middle).count()/ops);
+      std::cout<<"Operation cost: handler "<<handler<<" ns, co_await "<<awaitable<<" ns"<<std::endl;
+    }
+  }
+  writer->abort();
+  reader->abort();
+  ict::asio::ioStop();
+  ict::asio::ioJoin();
+  return(r);
+#else
+  std::cout<<"Coroutines (co_await) are not supported"<<std::endl;
+  return(0);
+#endif
+}
+#endif
+//===========================================
@@ -0,0 +1,409 @@
+//! @file
+//! @brief ASIO coroutine module - header file.
+//! @author Mariusz Ornowski (mariusz.ornowski@ict-project.pl)
+//! @date 2020-2022
+//! @copyright ICT-Project Mariusz Ornowski (ict-project.pl)
+/* **************************************************************
+Copyright (c) 2020-2022, ICT-Project Mariusz Ornowski (ict-project.pl)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1. Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of the ICT-Project Mariusz Ornowski nor the names
+of its contributors may be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**************************************************************/
+#ifndef _ASIO_COROUTINE_HEADER
+#define _ASIO_COROUTINE_HEADER
+//============================================
+#include <tuple>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <utility>
+#include <type_traits>
+#include <asio/async_result.hpp>
+#include <asio/associated_executor.hpp>
+#include <asio/dispatch.hpp>
+#include <asio/system_executor.hpp>
+#ifdef ASIO_HAS_CO_AWAIT
+#include <asio/awaitable.hpp>
+#include <asio/use_awaitable.hpp>
+#endif
+#include "types.hpp"
+#include "connection.hpp"
+#include "connection-message.hpp"
+#include "timer.hpp"
+#include "lock.hpp"
+#include "broker.hpp"
+//============================================
+namespace ict { namespace asio { namespace coroutine {
+//============================================
+#ifdef ASIO_HAS_CO_AWAIT
+//! Domyślny token - funkcje zwracają ::asio::awaitable (do użycia z co_await).
+typedef ::asio::use_awaitable_t<> default_token_t;
+#else
+//! Domyślny token (bez obsługi co_await token musi zostać podany jawnie).
+typedef void default_token_t;
+#endif
+//! Przekazuje wynik do handlera za pomocą przypisanego do niego executora (np. wznawia korutynę w jej wątku).
+//! @param handler Handler utworzony przez ::asio::async_initiate().
+//! @param args Wynik operacji.
+template<class Handler,class... Args> void complete(Handler && handler,Args&&... args){
+  auto executor(::asio::get_associated_executor(handler,::asio::system_executor()));
+  ::asio::dispatch(executor,[handler=std::move(handler),args=std::make_tuple(std::forward<Args>(args)...)]() mutable {
+    std::apply(std::move(handler),std::move(args));
+  });
+}
+//! Uruchamia operację asynchroniczną (z funkcją zwrotną) jako operację ASIO z dowolnym tokenem (np. ::asio::use_awaitable).
+//! @param token Token ASIO.
+//! @param start Funkcja uruchamiająca operację - otrzymuje funkcję zwrotną, którą należy przekazać do operacji.
+template<class Signature,class Token,class Start> auto initiate(Token && token,Start && start){
+  return(::asio::async_initiate<Token,Signature>([](auto handler,std::decay_t<Start> start){
+    start([handler=std::move(handler)](auto &&... args) mutable {
+      complete(std::move(handler),std::forward<decltype(args)>(args)...);
+    });
+  },token,std::forward<Start>(start)));
+}
+#ifdef ASIO_HAS_CO_AWAIT
+//! Czy token to ::asio::use_awaitable (operacja może zostać zrealizowana bezpośrednio jako korutyna).
+template<class Token> constexpr bool is_awaitable_v=std::is_same_v<std::decay_t<Token>,::asio::use_awaitable_t<>>;
+//! Odczytuje nagłówki w pętli korutyny (patrz connection::async_read_headers()).
+::asio::awaitable<void> read_headers(connection::message_ptr ptr,ict::asio::message::headers_t & headers);
+//! Zapisuje nagłówki w pętli korutyny (patrz connection::async_write_headers()).
+::asio::awaitable<void> write_headers(connection::message_ptr ptr,ict::asio::message::headers_t & headers);
+//! Odczytuje wiersz zapytania oraz nagłówki w korutynie (patrz connection::async_read_request_headers()).
+::asio::awaitable<void> read_request_headers(connection::message_ptr ptr,ict::asio::message::request_headers_t & request);
+//! Zapisuje wiersz zapytania oraz nagłówki w korutynie (patrz connection::async_write_request_headers()).
+::asio::awaitable<void> write_request_headers(connection::message_ptr ptr,ict::asio::message::request_headers_t & request);
+//! Odczytuje wiersz odpowiedzi oraz nagłówki w korutynie (patrz connection::async_read_response_headers()).
+::asio::awaitable<void> read_response_headers(connection::message_ptr ptr,ict::asio::message::response_headers_t & response);
+//! Zapisuje wiersz odpowiedzi oraz nagłówki w korutynie (patrz connection::async_write_response_headers()).
+::asio::awaitable<void> write_response_headers(connection::message_ptr ptr,ict::asio::message::response_headers_t & response);
+#endif
+//============================================
+}
+namespace connection {
+//============================================
+//! Zapisuje dane do połączenia (patrz interface::async_write_some()).
+//! @param ptr Połączenie.
+//! @param buffer Bufor z danymi do zapisu (musi istnieć do zakończenia operacji).
+//! @param token Token ASIO (domyślnie ::asio::use_awaitable - zwraca liczbę zapisanych bajtów).
+template<class Token=coroutine::default_token_t> auto async_write_some(const interface_ptr & ptr,interface::buffer_t & buffer,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t,std::size_t)>(std::forward<Token>(token),[ptr,&buffer](auto handler){
+    ptr->async_write_some(buffer,std::move(handler));
+  }));
+}
+//! Odczytuje dane z połączenia (patrz interface::async_read_some()).
+//! @param ptr Połączenie.
+//! @param buffer Bufor dla danych z odczytu (musi istnieć do zakończenia operacji).
+//! @param token Token ASIO (domyślnie ::asio::use_awaitable - zwraca liczbę odczytanych bajtów).
+template<class Token=coroutine::default_token_t> auto async_read_some(const interface_ptr & ptr,interface::buffer_t & buffer,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t,std::size_t)>(std::forward<Token>(token),[ptr,&buffer](auto handler){
+    ptr->async_read_some(buffer,std::move(handler));
+  }));
+}
+//! Zapisuje dane z wielu buforów naraz (patrz interface::async_write_some(buffers_t&,handler_t)).
+//! @param ptr Połączenie.
+//! @param buffers Bufory z danymi do zapisu (muszą istnieć do zakończenia operacji).
+//! @param token Token ASIO (domyślnie ::asio::use_awaitable - zwraca liczbę zapisanych bajtów).
+template<class Token=coroutine::default_token_t> auto async_write_some(const interface_ptr & ptr,interface::buffers_t & buffers,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t,std::size_t)>(std::forward<Token>(token),[ptr,&buffers](auto handler){
+    ptr->async_write_some(buffers,std::move(handler));
+  }));
+}
+//! Odczytuje dane do wielu buforów naraz (patrz interface::async_read_some(buffers_t&,handler_t)).
+//! @param ptr Połączenie.
+//! @param buffers Bufory dla danych z odczytu (muszą istnieć do zakończenia operacji).
+//! @param token Token ASIO (domyślnie ::asio::use_awaitable - zwraca liczbę odczytanych bajtów).
+template<class Token=coroutine::default_token_t> auto async_read_some(const interface_ptr & ptr,interface::buffers_t & buffers,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t,std::size_t)>(std::forward<Token>(token),[ptr,&buffers](auto handler){
+    ptr->async_read_some(buffers,std::move(handler));
+  }));
+}
+//! Zapisuje dane z dowolnego miejsca w pamięci - bez kopiowania (patrz interface::async_write_some(const ::asio::const_buffer&,handler_t)).
+//! @param ptr Połączenie.
+//! @param view Widok danych do zapisu (dane muszą istnieć do zakończenia operacji).
+//! @param token Token ASIO (domyślnie ::asio::use_awaitable - zwraca liczbę zapisanych bajtów).
+template<class Token=coroutine::default_token_t> auto async_write_some(const interface_ptr & ptr,const ::asio::const_buffer & view,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t,std::size_t)>(std::forward<Token>(token),[ptr,view](auto handler){
+    ptr->async_write_some(view,std::move(handler));
+  }));
+}
+//! Odczytuje dane do dowolnego miejsca w pamięci - bez kopiowania (patrz interface::async_read_some(const ::asio::mutable_buffer&,handler_t)).
+//! @param ptr Połączenie.
+//! @param view Widok pamięci dla danych z odczytu (pamięć musi istnieć do zakończenia operacji).
+//! @param token Token ASIO (domyślnie ::asio::use_awaitable - zwraca liczbę odczytanych bajtów).
+template<class Token=coroutine::default_token_t> auto async_read_some(const interface_ptr & ptr,const ::asio::mutable_buffer & view,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t,std::size_t)>(std::forward<Token>(token),[ptr,view](auto handler){
+    ptr->async_read_some(view,std::move(handler));
+  }));
+}
+//! Zapisuje cały bufor (patrz interface::async_write_all(buffer_t&,handler_t)).
+//! @param token Token ASIO (domyślnie ::asio::use_awaitable - zwraca liczbę zapisanych bajtów).
+template<class Token=coroutine::default_token_t> auto async_write_all(const interface_ptr & ptr,interface::buffer_t & buffer,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t,std::size_t)>(std::forward<Token>(token),[ptr,&buffer](auto handler){
+    ptr->async_write_all(buffer,std::move(handler));
+  }));
+}
+//! Odczytuje dokładnie buffer.size() bajtów (patrz interface::async_read_exact(buffer_t&,handler_t)).
+//! @param token Token ASIO (domyślnie ::asio::use_awaitable - zwraca liczbę odczytanych bajtów).
+template<class Token=coroutine::default_token_t> auto async_read_exact(const interface_ptr & ptr,interface::buffer_t & buffer,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t,std::size_t)>(std::forward<Token>(token),[ptr,&buffer](auto handler){
+    ptr->async_read_exact(buffer,std::move(handler));
+  }));
+}
+//! Zapisuje wszystkie dane z dowolnego miejsca w pamięci (patrz interface::async_write_all(const ::asio::const_buffer&,handler_t)).
+//! @param token Token ASIO (domyślnie ::asio::use_awaitable - zwraca liczbę zapisanych bajtów).
+template<class Token=coroutine::default_token_t> auto async_write_all(const interface_ptr & ptr,const ::asio::const_buffer & view,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t,std::size_t)>(std::forward<Token>(token),[ptr,view](auto handler){
+    ptr->async_write_all(view,std::move(handler));
+  }));
+}
+//! Odczytuje dokładnie view.size() bajtów do dowolnego miejsca w pamięci (patrz interface::async_read_exact(const ::asio::mutable_buffer&,handler_t)).
+//! @param token Token ASIO (domyślnie ::asio::use_awaitable - zwraca liczbę odczytanych bajtów).
+template<class Token=coroutine::default_token_t> auto async_read_exact(const interface_ptr & ptr,const ::asio::mutable_buffer & view,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t,std::size_t)>(std::forward<Token>(token),[ptr,view](auto handler){
+    ptr->async_read_exact(view,std::move(handler));
+  }));
+}
+//! Odczytuje dane do wystąpienia ogranicznika (patrz interface::async_read_until()).
+//! @param token Token ASIO (domyślnie ::asio::use_awaitable - zwraca rozmiar danych wraz z ogranicznikiem).
+template<class Token=coroutine::default_token_t> auto async_read_until(const interface_ptr & ptr,interface::buffer_t & buffer,const std::string & delimiter,std::size_t max=0x10000,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t,std::size_t)>(std::forward<Token>(token),[ptr,&buffer,delimiter,max](auto handler){
+    ptr->async_read_until(buffer,delimiter,std::move(handler),max);
+  }));
+}
+//! Wysyła dane z pliku (patrz interface::async_send_file()).
+//! @param fd Deskryptor pliku (musi pozostać otwarty do zakończenia operacji).
+//! @param token Token ASIO (domyślnie ::asio::use_awaitable - zwraca liczbę wysłanych bajtów).
+template<class Token=coroutine::default_token_t> auto async_send_file(const interface_ptr & ptr,int fd,std::size_t offset,std::size_t length,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t,std::size_t)>(std::forward<Token>(token),[ptr,fd,offset,length](auto handler){
+    ptr->async_send_file(fd,offset,length,std::move(handler));
+  }));
+}
+//! Dodaje dane do kolejki zapisu i czeka na ich zapis (patrz interface::enqueue()).
+//! @param owner Właściciel danych (przechowywany do zakończenia zapisu).
+//! @param view Widok danych do zapisu.
+//! @param token Token ASIO (domyślnie ::asio::use_awaitable - zwraca liczbę zapisanych bajtów).
+template<class Token=coroutine::default_token_t> auto async_enqueue(const interface_ptr & ptr,const std::shared_ptr<const void> & owner,const ::asio::const_buffer & view,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t,std::size_t)>(std::forward<Token>(token),[ptr,owner,view](auto handler){
+    ptr->enqueue(owner,view,std::move(handler));
+  }));
+}
+//! Uzgadnia połączenie SSL (patrz interface::async_handshake()).
+//! @param token Token ASIO (domyślnie ::asio::use_awaitable).
+template<class Token=coroutine::default_token_t> auto async_handshake(const interface_ptr & ptr,bool server,const std::string & session,const std::chrono::milliseconds & timeout,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t)>(std::forward<Token>(token),[ptr,server,session,timeout](auto handler){
+    ptr->async_handshake(server,session,timeout,std::move(handler));
+  }));
+}
+//! Zapisuje wiersz zapytania (patrz message::async_write_request()).
+template<class Token=coroutine::default_token_t> auto async_write_request(const message_ptr & ptr,ict::asio::message::request_t & request,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t)>(std::forward<Token>(token),[ptr,&request](auto handler){
+    ptr->async_write_request(request,std::move(handler));
+  }));
+}
+//! Odczytuje wiersz zapytania (patrz message::async_read_request()).
+template<class Token=coroutine::default_token_t> auto async_read_request(const message_ptr & ptr,ict::asio::message::request_t & request,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t)>(std::forward<Token>(token),[ptr,&request](auto handler){
+    ptr->async_read_request(request,std::move(handler));
+  }));
+}
+//! Zapisuje wiersz odpowiedzi (patrz message::async_write_response()).
+template<class Token=coroutine::default_token_t> auto async_write_response(const message_ptr & ptr,ict::asio::message::response_t & response,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t)>(std::forward<Token>(token),[ptr,&response](auto handler){
+    ptr->async_write_response(response,std::move(handler));
+  }));
+}
+//! Odczytuje wiersz odpowiedzi (patrz message::async_read_response()).
+template<class Token=coroutine::default_token_t> auto async_read_response(const message_ptr & ptr,ict::asio::message::response_t & response,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t)>(std::forward<Token>(token),[ptr,&response](auto handler){
+    ptr->async_read_response(response,std::move(handler));
+  }));
+}
+//! Zapisuje nagłówek (patrz message::async_write_header()).
+template<class Token=coroutine::default_token_t> auto async_write_header(const message_ptr & ptr,ict::asio::message::header_t & header,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t)>(std::forward<Token>(token),[ptr,&header](auto handler){
+    ptr->async_write_header(header,std::move(handler));
+  }));
+}
+//! Odczytuje nagłówek (patrz message::async_read_header()).
+template<class Token=coroutine::default_token_t> auto async_read_header(const message_ptr & ptr,ict::asio::message::header_t & header,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t)>(std::forward<Token>(token),[ptr,&header](auto handler){
+    ptr->async_read_header(header,std::move(handler));
+  }));
+}
+//! Zapisuje nagłówki (patrz message::async_write_headers()).
+template<class Token=coroutine::default_token_t> auto async_write_headers(const message_ptr & ptr,ict::asio::message::headers_t & headers,Token && token=Token()){
+#ifdef ASIO_HAS_CO_AWAIT
+  if constexpr (coroutine::is_awaitable_v<Token>) return(coroutine::write_headers(ptr,headers));
+  else
+#endif
+  return(coroutine::initiate<void(error_code_t)>(std::forward<Token>(token),[ptr,&headers](auto handler){
+    ptr->async_write_headers(headers,std::move(handler));
+  }));
+}
+//! Odczytuje nagłówki (patrz message::async_read_headers()).
+template<class Token=coroutine::default_token_t> auto async_read_headers(const message_ptr & ptr,ict::asio::message::headers_t & headers,Token && token=Token()){
+#ifdef ASIO_HAS_CO_AWAIT
+  if constexpr (coroutine::is_awaitable_v<Token>) return(coroutine::read_headers(ptr,headers));
+  else
+#endif
+  return(coroutine::initiate<void(error_code_t)>(std::forward<Token>(token),[ptr,&headers](auto handler){
+    ptr->async_read_headers(headers,std::move(handler));
+  }));
+}
+//! Zapisuje dane body wiadomości (patrz message::async_write_body()).
+template<class Token=coroutine::default_token_t> auto async_write_body(const message_ptr & ptr,std::string & data,std::size_t & bytesLeft,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t)>(std::forward<Token>(token),[ptr,&data,&bytesLeft](auto handler){
+    ptr->async_write_body(data,bytesLeft,std::move(handler));
+  }));
+}
+//! Odczytuje dane body wiadomości (patrz message::async_read_body()).
+template<class Token=coroutine::default_token_t> auto async_read_body(const message_ptr & ptr,std::string & data,std::size_t & bytesLeft,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t)>(std::forward<Token>(token),[ptr,&data,&bytesLeft](auto handler){
+    ptr->async_read_body(data,bytesLeft,std::move(handler));
+  }));
+}
+//! Zapisuje wiersz zapytania oraz nagłówki (patrz message::async_write_request_headers()).
+template<class Token=coroutine::default_token_t> auto async_write_request_headers(const message_ptr & ptr,ict::asio::message::request_headers_t & request,Token && token=Token()){
+#ifdef ASIO_HAS_CO_AWAIT
+  if constexpr (coroutine::is_awaitable_v<Token>) return(coroutine::write_request_headers(ptr,request));
+  else
+#endif
+  return(coroutine::initiate<void(error_code_t)>(std::forward<Token>(token),[ptr,&request](auto handler){
+    ptr->async_write_request_headers(request,std::move(handler));
+  }));
+}
+//! Odczytuje wiersz zapytania oraz nagłówki (patrz message::async_read_request_headers()).
+template<class Token=coroutine::default_token_t> auto async_read_request_headers(const message_ptr & ptr,ict::asio::message::request_headers_t & request,Token && token=Token()){
+#ifdef ASIO_HAS_CO_AWAIT
+  if constexpr (coroutine::is_awaitable_v<Token>) return(coroutine::read_request_headers(ptr,request));
+  else
+#endif
+  return(coroutine::initiate<void(error_code_t)>(std::forward<Token>(token),[ptr,&request](auto handler){
+    ptr->async_read_request_headers(request,std::move(handler));
+  }));
+}
+//! Zapisuje wiersz odpowiedzi oraz nagłówki (patrz message::async_write_response_headers()).
+template<class Token=coroutine::default_token_t> auto async_write_response_headers(const message_ptr & ptr,ict::asio::message::response_headers_t & response,Token && token=Token()){
+#ifdef ASIO_HAS_CO_AWAIT
+  if constexpr (coroutine::is_awaitable_v<Token>) return(coroutine::write_response_headers(ptr,response));
+  else
+#endif
+  return(coroutine::initiate<void(error_code_t)>(std::forward<Token>(token),[ptr,&response](auto handler){
+    ptr->async_write_response_headers(response,std::move(handler));
+  }));
+}
+//! Odczytuje wiersz odpowiedzi oraz nagłówki (patrz message::async_read_response_headers()).
+template<class Token=coroutine::default_token_t> auto async_read_response_headers(const message_ptr & ptr,ict::asio::message::response_headers_t & response,Token && token=Token()){
+#ifdef ASIO_HAS_CO_AWAIT
+  if constexpr (coroutine::is_awaitable_v<Token>) return(coroutine::read_response_headers(ptr,response));
+  else
+#endif
+  return(coroutine::initiate<void(error_code_t)>(std::forward<Token>(token),[ptr,&response](auto handler){
+    ptr->async_read_response_headers(response,std::move(handler));
+  }));
+}
+//============================================
+}
+namespace timer {
+//============================================
+//! Oczekuje na timer (patrz interface::async_wait()).
+//! @param ptr Timer.
+//! @param token Token ASIO (domyślnie ::asio::use_awaitable).
+template<class Token=coroutine::default_token_t> auto async_wait(const interface_ptr & ptr,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t)>(std::forward<Token>(token),[ptr](auto handler){
+    ptr->async_wait(std::move(handler));
+  }));
+}
+//============================================
+}
+namespace lock {
+//============================================
+//! Pobiera asynchronicznie locka o podanym kluczu (patrz get()).
+//! @param key Unikalny klucz locka.
+//! @param token Token ASIO (domyślnie ::asio::use_awaitable - zwraca wskaźnik do locka).
+template<class Token=coroutine::default_token_t> auto async_get(const std::string & key,Token && token=Token()){
+  return(coroutine::initiate<void(interface_ptr)>(std::forward<Token>(token),[key](auto handler){
+    get(key,std::move(handler));
+  }));
+}
+//============================================
+}
+namespace broker {
+//============================================
+//! Pobiera asynchronicznie połączenie brokera TCP (patrz get()).
+//! @param token Token ASIO (domyślnie ::asio::use_awaitable - zwraca wskaźnik do interfejsu).
+template<class Token=coroutine::default_token_t> auto async_get(const std::string & host,const std::string & port,bool server=true,const ict::asio::context_ptr & context=NULL,const std::string & sni="",Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t,interface_ptr)>(std::forward<Token>(token),[host,port,server,context,sni](auto handler){
+    get(std::move(handler),host,port,server,context,sni);
+  }));
+}
+//! Pobiera asynchronicznie połączenie brokera (gniazdo lokalne - patrz get()).
+//! @param token Token ASIO (domyślnie ::asio::use_awaitable - zwraca wskaźnik do interfejsu).
+template<class Token=coroutine::default_token_t> auto async_get(const std::string & path,bool server=true,const ict::asio::context_ptr & context=NULL,const std::string & sni="",Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t,interface_ptr)>(std::forward<Token>(token),[path,server,context,sni](auto handler){
+    get(std::move(handler),path,server,context,sni);
+  }));
+}
+//! Zapisuje body wiadomości (patrz interface::async_write_body()).
+template<class Token=coroutine::default_token_t> auto async_write_body(const interface_ptr & ptr,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t)>(std::forward<Token>(token),[ptr](auto handler){
+    ptr->async_write_body(std::move(handler));
+  }));
+}
+//! Odczytuje body wiadomości (patrz interface::async_read_body()).
+template<class Token=coroutine::default_token_t> auto async_read_body(const interface_ptr & ptr,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t)>(std::forward<Token>(token),[ptr](auto handler){
+    ptr->async_read_body(std::move(handler));
+  }));
+}
+//! Zapisuje wiersz zapytania oraz nagłówki (patrz interface::async_write_request_headers()).
+template<class Token=coroutine::default_token_t> auto async_write_request_headers(const interface_ptr & ptr,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t)>(std::forward<Token>(token),[ptr](auto handler){
+    ptr->async_write_request_headers(std::move(handler));
+  }));
+}
+//! Odczytuje wiersz zapytania oraz nagłówki (patrz interface::async_read_request_headers()).
+template<class Token=coroutine::default_token_t> auto async_read_request_headers(const interface_ptr & ptr,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t)>(std::forward<Token>(token),[ptr](auto handler){
+    ptr->async_read_request_headers(std::move(handler));
+  }));
+}
+//! Zapisuje wiersz odpowiedzi oraz nagłówki (patrz interface::async_write_response_headers()).
+template<class Token=coroutine::default_token_t> auto async_write_response_headers(const interface_ptr & ptr,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t)>(std::forward<Token>(token),[ptr](auto handler){
+    ptr->async_write_response_headers(std::move(handler));
+  }));
+}
+//! Odczytuje wiersz odpowiedzi oraz nagłówki (patrz interface::async_read_response_headers()).
+template<class Token=coroutine::default_token_t> auto async_read_response_headers(const interface_ptr & ptr,Token && token=Token()){
+  return(coroutine::initiate<void(error_code_t)>(std::forward<Token>(token),[ptr](auto handler){
+    ptr->async_read_response_headers(std::move(handler));
+  }));
+}
+//============================================
+}}}
+//===========================================
+#endif
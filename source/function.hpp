@@ -0,0 +1,218 @@
+//! @file
+//! @brief Move-only function wrapper - header file.
+//! @author Mariusz Ornowski (mariusz.ornowski@ict-project.pl)
+//! @date 2022
+//! @copyright ICT-Project Mariusz Ornowski (ict-project.pl)
+/* **************************************************************
+Copyright (c) 2022, ICT-Project Mariusz Ornowski (ict-project.pl)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1. Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of the ICT-Project Mariusz Ornowski nor the names
+of its contributors may be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**************************************************************/
+#ifndef _ASIO_FUNCTION_HEADER
+#define _ASIO_FUNCTION_HEADER
+//============================================
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <functional>
+#include <type_traits>
+#include "memory.hpp"
+//============================================
+namespace ict { namespace asio {
+//============================================
+template<class Signature> class unique_function;
+//! Odpowiednik std::function, który przyjmuje funkcje bez możliwości kopiowania (np. lambdy z std::unique_ptr).
+//! Małe funkcje są przechowywane w obiekcie, większe - w pamięci z ioMemoryAllocate().
+template<class R,class... Args> class unique_function<R(Args...)> {
+private:
+  //! Rozmiar bufora na funkcję w obiekcie.
+  static constexpr std::size_t _local_size_=6*sizeof(void*);
+  typedef typename std::aligned_storage<_local_size_,alignof(std::max_align_t)>::type storage_t;
+  //! Operacje na przechowywanej funkcji.
+  struct vtable_t {
+    R (*invoke)(storage_t &,Args&&...);
+    void (*move)(storage_t &,storage_t &) noexcept;
+    void (*destroy)(storage_t &) noexcept;
+  };
+  template<class F> static constexpr bool is_local(){
+    return((sizeof(F)<=_local_size_)&&(alignof(F)<=alignof(storage_t))&&std::is_nothrow_move_constructible<F>::value);
+  }
+  template<class F> static F * local(storage_t & s) noexcept {
+    return(std::launder(reinterpret_cast<F*>(&s)));
+  }
+  template<class F> static F *& remote(storage_t & s) noexcept {
+    return(*std::launder(reinterpret_cast<F**>(&s)));
+  }
+  template<class F> static void * acquire(){
+    if constexpr (alignof(F)>alignof(std::max_align_t)) {
+      return(::operator new(sizeof(F),std::align_val_t(alignof(F))));
+    } else {
+      return(ioMemoryAllocate(sizeof(F)));
+    }
+  }
+  template<class F> static void release(void * p) noexcept {
+    if constexpr (alignof(F)>alignof(std::max_align_t)) {
+      ::operator delete(p,std::align_val_t(alignof(F)));
+    } else {
+      ioMemoryDeallocate(p,sizeof(F));
+    }
+  }
+  template<class F> static const vtable_t * vtableLocal(){
+    static const vtable_t v{
+      [](storage_t & s,Args&&... args)->R{
+        return(static_cast<R>(std::invoke(*local<F>(s),std::forward<Args>(args)...)));
+      },
+      [](storage_t & d,storage_t & s) noexcept {
+        ::new (static_cast<void*>(&d)) F(std::move(*local<F>(s)));
+        local<F>(s)->~F();
+      },
+      [](storage_t & s) noexcept {
+        local<F>(s)->~F();
+      }
+    };
+    return(&v);
+  }
+  template<class F> static const vtable_t * vtableRemote(){
+    static const vtable_t v{
+      [](storage_t & s,Args&&... args)->R{
+        return(static_cast<R>(std::invoke(*remote<F>(s),std::forward<Args>(args)...)));
+      },
+      [](storage_t & d,storage_t & s) noexcept {
+        ::new (static_cast<void*>(&d)) F*(remote<F>(s));
+      },
+      [](storage_t & s) noexcept {
+        F * f(remote<F>(s));
+        f->~F();
+        release<F>(f);
+      }
+    };
+    return(&v);
+  }
+  template<class F> static bool is_empty(const F &) noexcept {
+    return(false);
+  }
+  template<class S> static bool is_empty(const std::function<S> & f) noexcept {
+    return(!f);
+  }
+  template<class S> static bool is_empty(S * f) noexcept {
+    return(f==nullptr);
+  }
+  mutable storage_t storage;
+  const vtable_t * vtable=nullptr;
+  void reset() noexcept {
+    if (vtable) vtable->destroy(storage);
+    vtable=nullptr;
+  }
+public:
+  typedef R result_type;
+  //! Konstruktor - pusta funkcja.
+  unique_function() noexcept {}
+  unique_function(std::nullptr_t) noexcept {}
+  //! Konstruktor.
+  //! @param f Funkcja (dowolny obiekt, który można wywołać z parametrami Args...).
+  template<class F,class D=typename std::decay<F>::type,class=typename std::enable_if<
+    !std::is_same<D,unique_function>::value&&
+    std::is_invocable_r<R,D&,Args...>::value
+  >::type> unique_function(F && f){
+    if (is_empty(f)) return;
+    if constexpr (is_local<D>()){
+      ::new (static_cast<void*>(&storage)) D(std::forward<F>(f));
+      vtable=vtableLocal<D>();
+    } else {
+      void * p(acquire<D>());
+      D * d(nullptr);
+      try {
+        d=::new (p) D(std::forward<F>(f));
+      } catch(...) {
+        release<D>(p);
+        throw;
+      }
+      ::new (static_cast<void*>(&storage)) D*(d);
+      vtable=vtableRemote<D>();
+    }
+  }
+  unique_function(unique_function && other) noexcept {
+    if (other.vtable) {
+      other.vtable->move(storage,other.storage);
+      vtable=other.vtable;
+      other.vtable=nullptr;
+    }
+  }
+  unique_function(const unique_function &)=delete;
+  //! Destruktor.
+  ~unique_function(){
+    reset();
+  }
+  unique_function & operator=(unique_function && other) noexcept {
+    if (this!=&other) {
+      reset();
+      if (other.vtable) {
+        other.vtable->move(storage,other.storage);
+        vtable=other.vtable;
+        other.vtable=nullptr;
+      }
+    }
+    return(*this);
+  }
+  unique_function & operator=(const unique_function &)=delete;
+  unique_function & operator=(std::nullptr_t) noexcept {
+    reset();
+    return(*this);
+  }
+  template<class F,class D=typename std::decay<F>::type,class=typename std::enable_if<
+    !std::is_same<D,unique_function>::value&&
+    std::is_invocable_r<R,D&,Args...>::value
+  >::type> unique_function & operator=(F && f){
+    unique_function(std::forward<F>(f)).swap(*this);
+    return(*this);
+  }
+  //! Zamienia funkcje.
+  void swap(unique_function & other) noexcept {
+    unique_function tmp(std::move(other));
+    other=std::move(*this);
+    *this=std::move(tmp);
+  }
+  //! Sprawdza, czy funkcja jest ustawiona.
+  explicit operator bool() const noexcept {
+    return(vtable!=nullptr);
+  }
+  //! Wywołuje funkcję (wyjątek std::bad_function_call, gdy funkcja nie jest ustawiona).
+  R operator()(Args... args) const {
+    if (!vtable) throw std::bad_function_call();
+    return(vtable->invoke(storage,std::forward<Args>(args)...));
+  }
+};
+template<class R,class... Args> bool operator==(const unique_function<R(Args...)> & f,std::nullptr_t) noexcept {
+  return(!f);
+}
+template<class R,class... Args> bool operator!=(const unique_function<R(Args...)> & f,std::nullptr_t) noexcept {
+  return(static_cast<bool>(f));
+}
+//============================================
+}}
+//===========================================
+#endif
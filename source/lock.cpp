@@ -54,17 +54,17 @@ private:
         return m;
     }
     static void post(asio_handler_t handler){
-        static ::asio::io_service::strand strand(ioService());
-        strand.post(handler);
+        static strand_t strand(ioService());
+        strand.post(std::move(handler));
     }
     implementation(const std::string & k):key(k){
         info[_key_]=k;
     }
 public:
-    static void get(const std::string & key, const lock_handler_t & handler){
-        post([key,handler](){
+    static void get(const std::string & key, lock_handler_t handler){
+        post([key,handler=std::move(handler)]() mutable {
             if (implementation::map().count(key)){
-                implementation::map()[key].push(handler);
+                implementation::map()[key].push(std::move(handler));
             } else {
                 implementation::map()[key];
                 handler(interface_ptr{new implementation(key)});
@@ -88,8 +88,8 @@ public:
     }
 };
 //============================================
-void get(const std::string & key, const lock_handler_t & handler){
-    implementation::get(key,handler);
+void get(const std::string & key, lock_handler_t handler){
+    implementation::get(key,std::move(handler));
 }
 //============================================
 }}}
@@ -52,7 +52,7 @@ public:
 //! Wskaźnik do interfejsu locka.
 typedef std::shared_ptr<interface> interface_ptr;
 //! Handler zwracający locka.
-typedef std::function<void(interface_ptr)> lock_handler_t;
+typedef unique_function<void(interface_ptr)> lock_handler_t;
 //===========================================
 //! 
 //! @brief Pobiera asunchronicznie locka o podanym kluczu. 
@@ -60,7 +60,7 @@ typedef std::function<void(interface_ptr)> lock_handler_t;
 //! @param key Unikalny klucz locka.
 //! @param handler Funkcja wywoływana, gdy lock został zwolniony - zwraca wskaźnik do locka.
 //! 
-void get(const std::string & key,const lock_handler_t & handler);
+void get(const std::string & key,lock_handler_t handler);
 //============================================
 }}}
 //===========================================
@@ -0,0 +1,179 @@
+//! @file
+//! @brief ASIO memory module - Source file.
+//! @author Mariusz Ornowski (mariusz.ornowski@ict-project.pl)
+//! @date 2020-2022
+//! @copyright ICT-Project Mariusz Ornowski (ict-project.pl)
+/* **************************************************************
+Copyright (c) 2020-2022, ICT-Project Mariusz Ornowski (ict-project.pl)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1. Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of the ICT-Project Mariusz Ornowski nor the names
+of its contributors may be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**************************************************************/
+//============================================
+#include <array>
+#include "memory.hpp"
+//============================================
+namespace ict { namespace asio {
+//============================================
+//! Rozmiary bloków w pamięci podręcznej.
+const static std::array<std::size_t,5> _memory_sizes_{64,128,256,512,1024};
+//! Maksymalna liczba wolnych bloków danego rozmiaru w pamięci podręcznej.
+const static std::size_t _memory_depth_(256);
+//! Wolny blok w pamięci podręcznej.
+struct memory_block_t {
+  memory_block_t * next;
+};
+//! Pamięć podręczna wątku.
+struct memory_cache_t {
+  std::array<memory_block_t*,_memory_sizes_.size()> head{};
+  std::array<std::size_t,_memory_sizes_.size()> count{};
+  memory_stats_t stats;
+  ~memory_cache_t();
+};
+//! Informacja, czy pamięć podręczna wątku została już usunięta (zakończenie wątku).
+static thread_local bool memoryCacheDone(false);
+memory_cache_t::~memory_cache_t(){
+  memoryCacheDone=true;
+  for (memory_block_t * b : head) while (b) {
+    memory_block_t * n(b->next);
+    ::operator delete(b);
+    b=n;
+  }
+}
+static memory_cache_t * memoryCache(){
+  if (memoryCacheDone) return(nullptr);
+  static thread_local memory_cache_t c;
+  return(&c);
+}
+static std::size_t memoryClass(std::size_t size){
+  for (std::size_t i=0;i<_memory_sizes_.size();i++) if (size<=_memory_sizes_[i]) return(i);
+  return(_memory_sizes_.size());
+}
+//============================================
+void * ioMemoryAllocate(std::size_t size){
+  memory_cache_t * c(memoryCache());
+  const std::size_t k(memoryClass(size));
+  if (c&&(k<_memory_sizes_.size())){
+    if (memory_block_t * b=c->head[k]){
+      c->head[k]=b->next;
+      c->count[k]--;
+      c->stats.recycled++;
+      return(b);
+    }
+    c->stats.allocated++;
+    return(::operator new(_memory_sizes_[k]));
+  }
+  if (c) c->stats.allocated++;
+  return(::operator new(size));
+}
+void ioMemoryDeallocate(void * pointer,std::size_t size){
+  if (!pointer) return;
+  memory_cache_t * c(memoryCache());
+  const std::size_t k(memoryClass(size));
+  if (c&&(k<_memory_sizes_.size())&&(c->count[k]<_memory_depth_)){
+    memory_block_t * b(static_cast<memory_block_t*>(pointer));
+    b->next=c->head[k];
+    c->head[k]=b;
+    c->count[k]++;
+    return;
+  }
+  ::operator delete(pointer);
+}
+memory_stats_t ioMemoryStats(){
+  memory_cache_t * c(memoryCache());
+  if (c) return(c->stats);
+  return(memory_stats_t());
+}
+//============================================
+}}
+//============================================
+#ifdef ENABLE_TESTING
+#include "test.hpp"
+#include <asio.hpp>
+#include "service.h"
+#include "function.hpp"
+REGISTER_TEST(memory,tc1){
+  {
+    void * p1(ict::asio::ioMemoryAllocate(100));
+    ict::asio::ioMemoryDeallocate(p1,100);
+    void * p2(ict::asio::ioMemoryAllocate(120));
+    ict::asio::ioMemoryDeallocate(p2,120);
+    if (p1!=p2) return(-1);
+  }
+  {
+    auto h(ict::asio::ioMemoryBind([](){}));
+    typedef decltype(::asio::get_associated_allocator(h)) allocator_t;
+    if (!std::is_same<allocator_t,ict::asio::memory_allocator_t<void>>::value) return(-2);
+  }
+  {
+    const std::size_t n(100000);
+    std::size_t k(0);
+    std::size_t warm(0);
+    ::asio::io_service io;
+    ict::asio::strand_t strand(io);
+    std::function<void()> step;
+    step=[&](){
+      if (++k==100) warm=ict::asio::ioMemoryStats().allocated;
+      if (k<n) strand.post([&](){step();});
+    };
+    strand.post([&](){step();});
+    io.run();
+    if (k!=n) return(-3);
+    std::cout<<"allocated: "<<(ict::asio::ioMemoryStats().allocated-warm)<<" (after warm-up), recycled: "<<ict::asio::ioMemoryStats().recycled<<std::endl;
+    if (ict::asio::ioMemoryStats().allocated!=warm) return(-4);
+  }
+  return(0);
+}
+REGISTER_TEST(memory,tc2){
+  {
+    std::unique_ptr<int> value(new int(2));
+    ict::asio::unique_function<int(int)> f([value=std::move(value)](int a){return(a+*value);});
+    ict::asio::unique_function<int(int)> g(std::move(f));
+    if (f) return(-1);
+    if (!g) return(-2);
+    if (g(1)!=3) return(-3);
+  }
+  {
+    std::array<char,512> big{};
+    big[0]=1;
+    ict::asio::unique_function<int()> f([big](){return(big[0]);});
+    if (f()!=1) return(-4);
+    f=nullptr;
+    const ict::asio::memory_stats_t before(ict::asio::ioMemoryStats());
+    f=[big](){return(big[0]+1);};
+    if (f()!=2) return(-5);
+    if (ict::asio::ioMemoryStats().allocated!=before.allocated) return(-6);
+    if (ict::asio::ioMemoryStats().recycled!=(before.recycled+1)) return(-7);
+  }
+  {
+    std::function<void()> empty;
+    ict::asio::unique_function<void()> f(empty);
+    if (f) return(-8);
+  }
+  return(0);
+}
+#endif
+//===========================================
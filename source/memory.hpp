@@ -0,0 +1,121 @@
+//! @file
+//! @brief ASIO memory module - header file.
+//! @author Mariusz Ornowski (mariusz.ornowski@ict-project.pl)
+//! @date 2020-2022
+//! @copyright ICT-Project Mariusz Ornowski (ict-project.pl)
+/* **************************************************************
+Copyright (c) 2020-2022, ICT-Project Mariusz Ornowski (ict-project.pl)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1. Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of the ICT-Project Mariusz Ornowski nor the names
+of its contributors may be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**************************************************************/
+#ifndef _ASIO_MEMORY_HEADER
+#define _ASIO_MEMORY_HEADER
+//============================================
+#include <cstddef>
+#include <new>
+#include <memory>
+#include <utility>
+#include <type_traits>
+//============================================
+namespace ict { namespace asio {
+//============================================
+//! Statystyki alokacji pamięci dla zadań (dla bieżącego wątku).
+struct memory_stats_t {
+  std::size_t allocated=0; //!< Liczba bloków zaalokowanych przez ::operator new.
+  std::size_t recycled=0; //!< Liczba bloków ponownie użytych (bez ::operator new).
+};
+//! Alokuje blok pamięci dla zadania - bloki do 1024 bajtów są ponownie używane (pamięć podręczna bieżącego wątku).
+//! @param size Rozmiar bloku.
+//! @returns Wskaźnik do bloku.
+void * ioMemoryAllocate(std::size_t size);
+//! Zwalnia blok pamięci zaalokowany przez ioMemoryAllocate() - blok trafia do pamięci podręcznej bieżącego wątku.
+//! @param pointer Wskaźnik do bloku.
+//! @param size Rozmiar bloku (taki sam jak w ioMemoryAllocate()).
+void ioMemoryDeallocate(void * pointer,std::size_t size);
+//! Zwraca statystyki alokacji pamięci dla bieżącego wątku.
+memory_stats_t ioMemoryStats();
+//! Alokator korzystający z ioMemoryAllocate() i ioMemoryDeallocate().
+template<class T> class memory_allocator_t {
+public:
+  typedef T value_type;
+  memory_allocator_t() noexcept {}
+  template<class U> memory_allocator_t(const memory_allocator_t<U> &) noexcept {}
+  template<class U> struct rebind {
+    typedef memory_allocator_t<U> other;
+  };
+  T * allocate(std::size_t n){
+    if (alignof(T)>alignof(std::max_align_t)) return(std::allocator<T>().allocate(n));
+    return(static_cast<T*>(ioMemoryAllocate(sizeof(T)*n)));
+  }
+  void deallocate(T * p,std::size_t n){
+    if (alignof(T)>alignof(std::max_align_t)) return(std::allocator<T>().deallocate(p,n));
+    ioMemoryDeallocate(p,sizeof(T)*n);
+  }
+  template<class U> bool operator==(const memory_allocator_t<U> &) const noexcept {
+    return(true);
+  }
+  template<class U> bool operator!=(const memory_allocator_t<U> &) const noexcept {
+    return(false);
+  }
+};
+//! Zadanie z przypisanym alokatorem memory_allocator_t (::asio::associated_allocator).
+template<class Handler> class memory_handler_t {
+private:
+  Handler handler;
+public:
+  typedef memory_allocator_t<void> allocator_type;
+  //! Konstruktor.
+  //! @param h Zadanie.
+  template<class H> explicit memory_handler_t(H && h):handler(std::forward<H>(h)){}
+  //! Zwraca alokator przypisany do zadania.
+  allocator_type get_allocator() const noexcept {
+    return(allocator_type());
+  }
+  //! Wykonuje zadanie.
+  template<class... Args> void operator()(Args&&... args){
+    handler(std::forward<Args>(args)...);
+  }
+};
+//! Przypisuje do zadania alokator memory_allocator_t - pamięć dla operacji ASIO związanych z zadaniem jest ponownie używana.
+//! @param handler Zadanie.
+//! @returns Zadanie z przypisanym alokatorem.
+template<class Handler> memory_handler_t<std::decay_t<Handler>> ioMemoryBind(Handler && handler){
+  return(memory_handler_t<std::decay_t<Handler>>(std::forward<Handler>(handler)));
+}
+template<class Handler> memory_handler_t<Handler> ioMemoryBind(memory_handler_t<Handler> && handler){
+  return(std::move(handler));
+}
+template<class Handler> memory_handler_t<Handler> ioMemoryBind(const memory_handler_t<Handler> & handler){
+  return(handler);
+}
+template<class Handler> memory_handler_t<Handler> ioMemoryBind(memory_handler_t<Handler> & handler){
+  return(handler);
+}
+//============================================
+}}
+//===========================================
+#endif
@@ -0,0 +1,374 @@
+//! @file
+//! @brief ASIO monitor module - Source file.
+//! @author Mariusz Ornowski (mariusz.ornowski@ict-project.pl)
+//! @date 2020-2022
+//! @copyright ICT-Project Mariusz Ornowski (ict-project.pl)
+/* **************************************************************
+Copyright (c) 2020-2022, ICT-Project Mariusz Ornowski (ict-project.pl)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1. Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of the ICT-Project Mariusz Ornowski nor the names
+of its contributors may be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**************************************************************/
+//============================================
+#include <map>
+#include <algorithm>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <asio.hpp>
+#include <asio/steady_timer.hpp>
+#include "service.h"
+#include "asio.hpp"
+#include "monitor.hpp"
+//============================================
+namespace ict { namespace asio {
+//============================================
+typedef std::chrono::steady_clock clock_t;
+//! Stan ::asio::io_service z puli.
+struct monitor_probe_t {
+  ::asio::steady_timer timer;
+  clock_t::time_point expected;
+  std::atomic<std::size_t> queued{0};
+  std::atomic<std::size_t> probes{0};
+  std::atomic<clock_t::rep> lag{0};
+  std::atomic<clock_t::rep> max_lag{0};
+  monitor_probe_t(::asio::io_service & io):timer(io){}
+};
+//! Stan wątku.
+struct monitor_thread_t {
+  int worker;
+  std::atomic<std::size_t> handlers{0};
+  std::atomic<clock_t::rep> total{0};
+  std::atomic<clock_t::rep> max{0};
+  std::array<std::atomic<std::size_t>,monitor_buckets> histogram{};
+  //! Początek wykonania bieżącego zadania (zero, gdy wątek nie wykonuje zadania).
+  std::atomic<clock_t::rep> started{0};
+  //! Numer bieżącego zadania.
+  std::atomic<std::size_t> sequence{0};
+  //! Numer ostatniego zadania zgłoszonego do watchdoga.
+  std::atomic<std::size_t> reported{0};
+  //! Zagnieżdżenie zadań (::asio::dispatch()).
+  std::size_t depth=0;
+  clock_t::time_point start;
+  monitor_thread_t(int w):worker(w){}
+};
+typedef std::shared_ptr<monitor_thread_t> monitor_thread_ptr;
+//! Informacja, czy istnieje monitor_t - zadania usuwane razem z pulą ::asio::io_service (po monitor_t) nie mogą odwoływać się do sond.
+static std::atomic<bool> & monitorExists(){
+  static std::atomic<bool> e(false);
+  return(e);
+}
+//! Stan monitorowania.
+struct monitor_t {
+  std::mutex mutex;
+  monitor_config_t config;
+  //! Stan ::asio::io_service z puli (tworzony raz - rozmiar puli nie zmienia się).
+  std::vector<std::unique_ptr<monitor_probe_t>> probes;
+  //! Stan wątków.
+  std::vector<monitor_thread_ptr> threads;
+  //! Wątek watchdoga.
+  std::thread watchdog;
+  std::condition_variable cv;
+  bool stop=false;
+  //! Kopia config.threshold (odczytywana przy każdym zadaniu).
+  std::atomic<clock_t::rep> threshold{0};
+  //! Kopia config.probe (odczytywana przez sondy w wątkach ::asio::io_service).
+  std::atomic<clock_t::rep> probe{0};
+  //! Dane zakończonych wątków (dla numeru wątku, patrz ioWorker()) - lista threads zawiera tylko bieżące wątki.
+  std::map<int,monitor_worker_t> retired;
+  monitor_t(){
+    //Pula ::asio::io_service musi zostać utworzona wcześniej (i usunięta później) niż sondy.
+    ioServiceSize();
+    monitorExists()=true;
+  }
+  ~monitor_t(){
+    monitorExists()=false;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      stop=true;
+    }
+    cv.notify_all();
+    if (watchdog.joinable()) watchdog.join();
+  }
+};
+static monitor_t & monitor(){
+  static monitor_t m;
+  return(m);
+}
+//! Informacja, czy monitorowanie jest włączone (poza monitor_t - sprawdzana przy każdym zadaniu).
+static std::atomic<bool> & monitorEnabled(){
+  static std::atomic<bool> e(false);
+  return(e);
+}
+static void monitorMax(std::atomic<clock_t::rep> & max,clock_t::rep value){
+  clock_t::rep old(max.load(std::memory_order_relaxed));
+  while ((old<value)&&!max.compare_exchange_weak(old,value,std::memory_order_relaxed)){}
+}
+//! Dodaje dane wątku do danych dla jego numeru (patrz ioMonitorSnapshot()).
+static void monitorAdd(monitor_worker_t & w,const monitor_thread_t & t){
+  w.worker=t.worker;
+  w.handlers+=t.handlers;
+  w.total+=monitor_duration_t(t.total.load());
+  w.max=std::max(w.max,monitor_duration_t(t.max.load()));
+  for (std::size_t b=0;b<monitor_buckets;b++) w.histogram[b]+=t.histogram[b];
+}
+//! Przenosi dane zakończonego wątku do monitor_t::retired i usuwa go z listy wątków.
+static void monitorRetire(const monitor_thread_ptr & t){
+  std::unique_lock<std::mutex> lock(monitor().mutex);
+  monitorAdd(monitor().retired[t->worker],*t);
+  std::vector<monitor_thread_ptr> & threads(monitor().threads);
+  threads.erase(std::remove(threads.begin(),threads.end(),t),threads.end());
+}
+//! Stan bieżącego wątku - usuwany z listy wątków po zakończeniu wątku (lub zmianie numeru wątku).
+struct monitor_current_t {
+  monitor_thread_ptr t;
+  ~monitor_current_t(){
+    if (t) monitorRetire(t);
+  }
+};
+static monitor_thread_t & monitorThread(){
+  static thread_local monitor_current_t current;
+  if (!current.t||(current.t->worker!=ioWorker())){
+    if (current.t) monitorRetire(current.t);
+    current.t=std::make_shared<monitor_thread_t>(ioWorker());
+    std::unique_lock<std::mutex> lock(monitor().mutex);
+    monitor().threads.push_back(current.t);
+  }
+  return(*current.t);
+}
+static std::size_t monitorBucket(monitor_duration_t duration){
+  const long long us(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+  std::size_t b(0);
+  while ((b<(monitor_buckets-1))&&((1LL<<b)<=us)) b++;
+  return(b);
+}
+//! Zgłasza przekroczenie progu (raz dla zadania).
+static void monitorReport(monitor_thread_t & t,std::size_t sequence,monitor_duration_t duration){
+  std::size_t reported(t.reported.load());
+  if (reported==sequence) return;
+  if (!t.reported.compare_exchange_strong(reported,sequence)) return;
+  watchdog_handler_t watchdog;
+  {
+    std::unique_lock<std::mutex> lock(monitor().mutex);
+    watchdog=monitor().config.watchdog;
+  }
+  if (watchdog) watchdog(t.worker,duration);
+}
+static void monitorProbe(std::size_t index){
+  monitor_probe_t & p(*monitor().probes.at(index));
+  p.expected=clock_t::now()+monitor_duration_t(monitor().probe.load());
+  p.timer.expires_at(p.expected);
+  p.timer.async_wait([index](const ::asio::error_code & ec){
+    if (ec) return;
+    monitor_probe_t & p(*monitor().probes.at(index));
+    const clock_t::rep lag((clock_t::now()-p.expected).count());
+    p.lag=lag;
+    monitorMax(p.max_lag,lag);
+    p.probes++;
+    if (monitorEnabled()) monitorProbe(index);
+  });
+}
+static void monitorWatchdog(){
+  std::unique_lock<std::mutex> lock(monitor().mutex);
+  while (!monitor().stop){
+    monitor().cv.wait_for(lock,monitor().config.probe);
+    if (monitor().stop) break;
+    const std::vector<monitor_thread_ptr> threads(monitor().threads);
+    const monitor_duration_t threshold(monitor().config.threshold);
+    lock.unlock();
+    const clock_t::rep now(clock_t::now().time_since_epoch().count());
+    for (const monitor_thread_ptr & t : threads){
+      const std::size_t sequence(t->sequence.load());
+      const clock_t::rep started(t->started.load());
+      if (started&&(threshold<monitor_duration_t(now-started))) monitorReport(*t,sequence,monitor_duration_t(now-started));
+    }
+    lock.lock();
+  }
+}
+//============================================
+void ioMonitorStart(const monitor_config_t & config){
+  ioMonitorStop();
+  std::unique_lock<std::mutex> lock(monitor().mutex);
+  monitor().config=config;
+  if (monitor().config.probe<=monitor_duration_t::zero()) monitor().config.probe=std::chrono::milliseconds(100);
+  monitor().threshold=monitor().config.threshold.count();
+  monitor().probe=monitor().config.probe.count();
+  if (monitor().probes.empty()) for (std::size_t i=0;i<ioServiceSize();i++) monitor().probes.emplace_back(new monitor_probe_t(ioService(i)));
+  monitorEnabled()=true;
+  monitor().stop=false;
+  monitor().watchdog=std::thread(monitorWatchdog);
+  for (std::size_t i=0;i<monitor().probes.size();i++) ::asio::post(ioService(i),[i](){
+    monitorProbe(i);
+  });
+}
+void ioMonitorStop(){
+  std::unique_lock<std::mutex> lock(monitor().mutex);
+  if (!monitorEnabled()) return;
+  monitorEnabled()=false;
+  monitor().stop=true;
+  monitor().cv.notify_all();
+  lock.unlock();
+  if (monitor().watchdog.joinable()) monitor().watchdog.join();
+  for (std::size_t i=0;i<monitor().probes.size();i++) ::asio::post(ioService(i),[i](){
+    monitor().probes.at(i)->timer.cancel();
+  });
+}
+bool ioMonitorEnabled(){
+  return(monitorEnabled());
+}
+monitor_snapshot_t ioMonitorSnapshot(){
+  monitor_snapshot_t s;
+  std::map<int,monitor_worker_t> workers;
+  std::unique_lock<std::mutex> lock(monitor().mutex);
+  s.time=clock_t::now();
+  for (std::size_t i=0;i<monitor().probes.size();i++){
+    const monitor_probe_t & p(*monitor().probes.at(i));
+    monitor_service_t service;
+    service.index=i;
+    service.queued=p.queued;
+    service.probes=p.probes;
+    service.lag=monitor_duration_t(p.lag.load());
+    service.max_lag=monitor_duration_t(p.max_lag.load());
+    s.services.push_back(service);
+  }
+  workers=monitor().retired;
+  for (const monitor_thread_ptr & t : monitor().threads){
+    monitor_worker_t & w(workers[t->worker]);
+    const clock_t::rep started(t->started.load());
+    monitorAdd(w,*t);
+    if (started) w.current=std::max(w.current,s.time-clock_t::time_point(monitor_duration_t(started)));
+  }
+  for (const auto & w : workers) s.workers.push_back(w.second);
+  return(s);
+}
+monitor_duration_t ioMonitorBucket(std::size_t bucket){
+  if ((monitor_buckets-1)<=bucket) return(monitor_duration_t::max());
+  return(std::chrono::microseconds(1LL<<bucket));
+}
+bool ioMonitorPosted(std::size_t queue){
+  if (!monitorEnabled()) return(false);
+  if (queue<monitor().probes.size()) monitor().probes[queue]->queued++;
+  return(true);
+}
+void ioMonitorDropped(std::size_t queue){
+  if (!monitorExists()) return;
+  if (queue<monitor().probes.size()) monitor().probes[queue]->queued--;
+}
+void ioMonitorBegin(std::size_t queue){
+  ioMonitorDropped(queue);
+  monitor_thread_t & t(monitorThread());
+  if (t.depth++) return;
+  t.start=clock_t::now();
+  t.sequence++;
+  t.started=t.start.time_since_epoch().count();
+}
+void ioMonitorEnd(){
+  monitor_thread_t & t(monitorThread());
+  if (--t.depth) return;
+  const monitor_duration_t duration(clock_t::now()-t.start);
+  t.started=0;
+  t.handlers++;
+  t.total+=duration.count();
+  monitorMax(t.max,duration.count());
+  t.histogram[monitorBucket(duration)]++;
+  if (monitor_duration_t(monitor().threshold.load(std::memory_order_relaxed))<duration) monitorReport(t,t.sequence,duration);
+}
+//============================================
+}}
+//============================================
+#ifdef ENABLE_TESTING
+#include "test.hpp"
+#include <future>
+REGISTER_TEST(monitor,tc1){
+  std::atomic<int> out(0);
+  std::atomic<int> watchdog(0);
+  std::promise<void> done;
+  std::future<void> f(done.get_future());
+  const auto blocked(std::chrono::milliseconds(200));
+  ict::asio::monitor_config_t config;
+  config.probe=std::chrono::milliseconds(10);
+  config.threshold=std::chrono::milliseconds(50);
+  config.watchdog=[&](int worker,ict::asio::monitor_duration_t duration){
+    watchdog++;
+  };
+  ict::asio::ioConfig().threads=1;
+  ict::asio::ioMonitorStart(config);
+  ict::asio::ioRun();
+  ict::asio::strand_t strand(ict::asio::ioService());
+  //Zadanie zablokowane na czas znacznie dłuższy niż config.threshold.
+  strand.post([&](){
+    std::this_thread::sleep_for(blocked);
+    out++;
+  });
+  for (int i=0;i<100;i++) strand.post([&](){
+    out++;
+  });
+  strand.post([&](){
+    done.set_value();
+  });
+  int r(0);
+  if (f.wait_for(std::chrono::seconds(10))!=std::future_status::ready) r=-1;
+  //Sonda działa co config.probe - oczekiwanie na pierwszy pomiar (bez ograniczenia czasu pomiaru).
+  for (int i=0;i<1000;i++){
+    const ict::asio::monitor_snapshot_t p(ict::asio::ioMonitorSnapshot());
+    if (p.services.empty()||p.services.at(0).probes) break;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ict::asio::ioMonitorStop();
+  ict::asio::ioStop();
+  ict::asio::ioJoin();
+  ict::asio::ioConfig().threads=0;
+  //Stan po zakończeniu wątków (dane zakończonych wątków są zachowane).
+  const ict::asio::monitor_snapshot_t s(ict::asio::ioMonitorSnapshot());
+  if (r) return(r);
+  if (out!=101) return(-2);
+  if (watchdog<1) return(-3);
+  if (s.services.empty()) return(-4);
+  if (s.services.at(0).queued) return(-5);
+  if (!s.services.at(0).probes) return(-6);
+  std::size_t handlers(0),histogram(0),slow(0);
+  ict::asio::monitor_duration_t max(ict::asio::monitor_duration_t::zero());
+  for (const auto & w : s.workers){
+    handlers+=w.handlers;
+    max=std::max(max,w.max);
+    for (std::size_t b=0;b<ict::asio::monitor_buckets;b++){
+      histogram+=w.histogram[b];
+      if (blocked<ict::asio::ioMonitorBucket(b)) slow+=w.histogram[b];
+    }
+    std::cout<<"worker "<<w.worker<<": handlers="<<w.handlers<<" max="<<std::chrono::duration_cast<std::chrono::microseconds>(w.max).count()<<"us"<<std::endl;
+  }
+  std::cout<<"max lag: "<<std::chrono::duration_cast<std::chrono::microseconds>(s.services.at(0).max_lag).count()<<"us"<<std::endl;
+  if (handlers<102) return(-7);
+  if (histogram!=handlers) return(-8);
+  //Czas zablokowanego zadania jest ograniczony tylko od dołu.
+  if (max<blocked) return(-9);
+  if (slow<1) return(-10);
+  return(0);
+}
+#endif
+//===========================================
@@ -0,0 +1,176 @@
+//! @file
+//! @brief ASIO monitor module - header file.
+//! @author Mariusz Ornowski (mariusz.ornowski@ict-project.pl)
+//! @date 2020-2022
+//! @copyright ICT-Project Mariusz Ornowski (ict-project.pl)
+/* **************************************************************
+Copyright (c) 2020-2022, ICT-Project Mariusz Ornowski (ict-project.pl)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1. Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of the ICT-Project Mariusz Ornowski nor the names
+of its contributors may be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**************************************************************/
+#ifndef _ASIO_MONITOR_HEADER
+#define _ASIO_MONITOR_HEADER
+//============================================
+#include <array>
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include <utility>
+#include <functional>
+#include "memory.hpp"
+//============================================
+namespace ict { namespace asio {
+//============================================
+//! Typ - czas (opóźnienie pętli, czas wykonania zadania).
+typedef std::chrono::steady_clock::duration monitor_duration_t;
+//! Funkcja wywoływana, gdy wykonanie jednego zadania trwa dłużej niż monitor_config_t::threshold.
+//! @param worker Numer wątku (patrz ioWorker()).
+//! @param duration Czas wykonania zadania (dotychczasowy, jeśli zadanie nadal jest wykonywane).
+typedef std::function<void(int worker,monitor_duration_t duration)> watchdog_handler_t;
+//! Liczba przedziałów histogramu czasu wykonania zadań - przedział i obejmuje czasy poniżej (1<<i) us, ostatni - pozostałe.
+const std::size_t monitor_buckets=24;
+//! Typ - histogram czasu wykonania zadań.
+typedef std::array<std::size_t,monitor_buckets> monitor_histogram_t;
+//! Konfiguracja monitorowania.
+struct monitor_config_t {
+  //! Okres sondy mierzącej opóźnienie pętli (oraz sprawdzania zadań przez watchdog).
+  monitor_duration_t probe=std::chrono::milliseconds(100);
+  //! Maksymalny czas wykonania jednego zadania (po przekroczeniu wywoływany jest watchdog).
+  monitor_duration_t threshold=std::chrono::milliseconds(100);
+  //! Funkcja wywoływana po przekroczeniu threshold (wywoływana raz dla zadania).
+  watchdog_handler_t watchdog;
+};
+//! Stan ::asio::io_service z puli.
+struct monitor_service_t {
+  //! Numer ::asio::io_service w puli.
+  std::size_t index=0;
+  //! Liczba zadań oczekujących na wykonanie.
+  std::size_t queued=0;
+  //! Liczba pomiarów opóźnienia pętli.
+  std::size_t probes=0;
+  //! Ostatnie opóźnienie pętli.
+  monitor_duration_t lag=monitor_duration_t::zero();
+  //! Największe opóźnienie pętli.
+  monitor_duration_t max_lag=monitor_duration_t::zero();
+};
+//! Stan wątku.
+struct monitor_worker_t {
+  //! Numer wątku (patrz ioWorker()).
+  int worker=-1;
+  //! Liczba wykonanych zadań.
+  std::size_t handlers=0;
+  //! Łączny czas wykonania zadań.
+  monitor_duration_t total=monitor_duration_t::zero();
+  //! Najdłuższy czas wykonania zadania.
+  monitor_duration_t max=monitor_duration_t::zero();
+  //! Czas wykonania bieżącego zadania (zero, gdy wątek nie wykonuje zadania).
+  monitor_duration_t current=monitor_duration_t::zero();
+  //! Histogram czasu wykonania zadań.
+  monitor_histogram_t histogram{};
+};
+//! Stan monitorowania.
+struct monitor_snapshot_t {
+  //! Czas utworzenia.
+  std::chrono::steady_clock::time_point time;
+  //! Stan ::asio::io_service z puli.
+  std::vector<monitor_service_t> services;
+  //! Stan wątków.
+  std::vector<monitor_worker_t> workers;
+};
+//! Włącza monitorowanie (sondy opóźnienia pętli, pomiar czasu wykonania zadań, watchdog).
+//! @param config Konfiguracja monitorowania.
+void ioMonitorStart(const monitor_config_t & config=monitor_config_t());
+//! Wyłącza monitorowanie (zebrane dane są zachowywane).
+void ioMonitorStop();
+//! Sprawdza, czy monitorowanie jest włączone.
+bool ioMonitorEnabled();
+//! Zwraca stan monitorowania.
+monitor_snapshot_t ioMonitorSnapshot();
+//! Zwraca górną granicę przedziału histogramu.
+//! @param bucket Numer przedziału.
+monitor_duration_t ioMonitorBucket(std::size_t bucket);
+//! Zgłasza zadanie dodane do kolejki ::asio::io_service (wewnętrzne - używane przez monitor_handler_t).
+//! @param queue Numer ::asio::io_service w puli (lub wartość spoza puli - bez liczenia zadań w kolejce).
+//! @returns Wartość true, jeśli zadanie jest monitorowane.
+bool ioMonitorPosted(std::size_t queue);
+//! Zgłasza usunięcie niewykonanego zadania (wewnętrzne - używane przez monitor_handler_t).
+void ioMonitorDropped(std::size_t queue);
+//! Zgłasza początek wykonania zadania (wewnętrzne - używane przez monitor_handler_t).
+void ioMonitorBegin(std::size_t queue);
+//! Zgłasza koniec wykonania zadania (wewnętrzne - używane przez monitor_handler_t).
+void ioMonitorEnd();
+//! Zadanie z pomiarem czasu wykonania i przypisanym alokatorem memory_allocator_t.
+template<class Handler> class monitor_handler_t {
+private:
+  Handler handler;
+  std::size_t queue;
+  bool pending;
+  struct end_t {
+    ~end_t(){
+      ioMonitorEnd();
+    }
+  };
+public:
+  typedef memory_allocator_t<void> allocator_type;
+  //! Konstruktor.
+  //! @param h Zadanie.
+  //! @param q Numer ::asio::io_service w puli, do którego trafia zadanie.
+  template<class H> monitor_handler_t(H && h,std::size_t q):handler(std::forward<H>(h)),queue(q),pending(ioMonitorPosted(q)){}
+  monitor_handler_t(monitor_handler_t && other):handler(std::move(other.handler)),queue(other.queue),pending(other.pending){
+    other.pending=false;
+  }
+  monitor_handler_t(const monitor_handler_t & other):handler(other.handler),queue(other.queue),pending(false){}
+  ~monitor_handler_t(){
+    if (pending) ioMonitorDropped(queue);
+  }
+  //! Zwraca alokator przypisany do zadania.
+  allocator_type get_allocator() const noexcept {
+    return(allocator_type());
+  }
+  //! Wykonuje zadanie.
+  template<class... Args> void operator()(Args&&... args){
+    if (pending){
+      pending=false;
+      ioMonitorBegin(queue);
+      end_t end;
+      handler(std::forward<Args>(args)...);
+    } else {
+      handler(std::forward<Args>(args)...);
+    }
+  }
+};
+//! Przypisuje do zadania pomiar czasu wykonania (gdy monitorowanie jest włączone) i alokator memory_allocator_t.
+//! @param handler Zadanie.
+//! @param queue Numer ::asio::io_service w puli, do którego trafia zadanie (domyślnie - bez liczenia zadań w kolejce).
+//! @returns Zadanie z pomiarem czasu wykonania.
+template<class Handler> monitor_handler_t<std::decay_t<Handler>> ioMonitorBind(Handler && handler,std::size_t queue=static_cast<std::size_t>(-1)){
+  return(monitor_handler_t<std::decay_t<Handler>>(std::forward<Handler>(handler),queue));
+}
+//============================================
+}}
+//===========================================
+#endif
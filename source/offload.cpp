@@ -0,0 +1,316 @@
+//! @file
+//! @brief ASIO offload module - Source file.
+//! @author Mariusz Ornowski (mariusz.ornowski@ict-project.pl)
+//! @date 2020-2022
+//! @copyright ICT-Project Mariusz Ornowski (ict-project.pl)
+/* **************************************************************
+Copyright (c) 2020-2022, ICT-Project Mariusz Ornowski (ict-project.pl)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1. Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of the ICT-Project Mariusz Ornowski nor the names
+of its contributors may be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**************************************************************/
+//============================================
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+#include <asio.hpp>
+#include "service.h"
+#include "asio.hpp"
+#include "offload.hpp"
+//============================================
+namespace ict { namespace asio {
+//============================================
+//! Kolejka zadań wątku.
+struct offload_queue_t {
+  std::mutex mutex;
+  std::deque<asio_handler_t> tasks;
+};
+//! Pula wątków do zadań obliczeniowych.
+struct offload_t {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool stop=false;
+  std::size_t capacity;
+  //! Kolejki zadań (jedna na wątek).
+  std::vector<std::unique_ptr<offload_queue_t>> queues;
+  std::vector<std::thread> threads;
+  //! Liczba miejsc zarezerwowanych w kolejkach (zadania w kolejkach i w trakcie dodawania).
+  std::atomic<std::size_t> reserved{0};
+  //! Liczba zadań w kolejkach (zwiększana po dodaniu zadania - wątki nie czekają na zadanie, którego jeszcze nie ma).
+  std::atomic<std::size_t> queued{0};
+  std::atomic<std::size_t> running{0};
+  std::atomic<std::size_t> completed{0};
+  std::atomic<std::size_t> rejected{0};
+  std::atomic<std::size_t> stolen{0};
+  std::atomic<std::size_t> next{0};
+  offload_t();
+  ~offload_t(){
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      stop=true;
+    }
+    cv.notify_all();
+    for (auto & t : threads) t.join();
+  }
+  //! Rezerwuje miejsce w kolejkach.
+  bool reserve(){
+    std::size_t old(reserved.load());
+    do {
+      if (capacity<=old) {
+        rejected++;
+        return(false);
+      }
+    } while (!reserved.compare_exchange_weak(old,old+1));
+    return(true);
+  }
+  void push(asio_handler_t && task);
+  bool pop(std::size_t index,asio_handler_t & task);
+  void run(std::size_t index);
+};
+offload_config_t & ioOffloadConfig(){
+  static offload_config_t config;
+  return(config);
+}
+static offload_t & offload(){
+  static offload_t o;
+  return(o);
+}
+//! Numer wątku puli, w którym wykonywany jest kod (-1 - poza pulą).
+static int & offloadIndex(){
+  static thread_local int index(-1);
+  return(index);
+}
+offload_t::offload_t(){
+  //Pula ::asio::io_service musi zostać utworzona wcześniej (i usunięta później) niż wątki, które przekazują do niej wyniki.
+  ioServiceSize();
+  std::size_t n(ioOffloadConfig().threads);
+  if (!n) n=std::thread::hardware_concurrency();
+  if (!n) n=1;
+  capacity=ioOffloadConfig().capacity?ioOffloadConfig().capacity:1;
+  for (std::size_t i=0;i<n;i++) queues.emplace_back(new offload_queue_t);
+  for (std::size_t i=0;i<n;i++) threads.emplace_back([this,i](){
+    run(i);
+  });
+}
+void offload_t::push(asio_handler_t && task){
+  //Zadanie zlecone z wątku puli trafia do jego własnej kolejki.
+  const std::size_t index((0<=offloadIndex())?offloadIndex():(next++%queues.size()));
+  {
+    std::unique_lock<std::mutex> lock(queues.at(index)->mutex);
+    queues.at(index)->tasks.push_back(std::move(task));
+    queued++;
+  }
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+  }
+  cv.notify_one();
+}
+bool offload_t::pop(std::size_t index,asio_handler_t & task){
+  for (std::size_t i=0;i<queues.size();i++){
+    offload_queue_t & q(*queues.at((index+i)%queues.size()));
+    std::unique_lock<std::mutex> lock(q.mutex);
+    if (q.tasks.empty()) continue;
+    if (i){
+      //Przejęcie zadania z końca kolejki innego wątku.
+      task=std::move(q.tasks.back());
+      q.tasks.pop_back();
+      stolen++;
+    } else {
+      task=std::move(q.tasks.front());
+      q.tasks.pop_front();
+    }
+    running++;
+    queued--;
+    reserved--;
+    return(true);
+  }
+  return(false);
+}
+void offload_t::run(std::size_t index){
+  offloadIndex()=index;
+  for(;;){
+    asio_handler_t task;
+    if (pop(index,task)){
+      task();
+      running--;
+      completed++;
+    } else {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock,[this](){
+        return(stop||queued);
+      });
+      if (stop) return;
+    }
+  }
+}
+offload_stats_t ioOffloadStats(){
+  offload_stats_t s;
+  s.threads=offload().threads.size();
+  s.capacity=offload().capacity;
+  s.queued=offload().queued;
+  s.running=offload().running;
+  s.completed=offload().completed;
+  s.rejected=offload().rejected;
+  s.stolen=offload().stolen;
+  return(s);
+}
+//! Zleca zadanie do puli.
+//! @param work Zadanie do wykonania.
+//! @param completion Funkcja wywoływana po wykonaniu zadania.
+//! @param post Funkcja przekazująca wynik do ::asio::io_service (lub ::asio::strand).
+template<class Post> static void offloadSubmit(asio_handler_t && work,offload_handler_t && completion,Post && post){
+  if (!offload().reserve()){
+    post([completion=std::move(completion)]() mutable {
+      completion(error_code_t(EBUSY,std::generic_category()),nullptr);
+    });
+    return;
+  }
+  offload().push([work=std::move(work),completion=std::move(completion),post=std::move(post)]() mutable {
+    error_code_t ec;
+    std::exception_ptr e;
+    try {
+      work();
+    } catch (...) {
+      ec=error_code_t(EFAULT,std::generic_category());
+      e=std::current_exception();
+    }
+    post([completion=std::move(completion),ec,e]() mutable {
+      completion(ec,e);
+    });
+  });
+}
+//! Funkcja zakończenia bez wyjątku (tylko kod błędu).
+static offload_handler_t offloadHandler(error_handler_t && completion){
+  return([completion=std::move(completion)](const error_code_t & ec,std::exception_ptr) mutable {
+    completion(ec);
+  });
+}
+void ioServiceOffload(asio_handler_t work,offload_handler_t completion){
+  ::asio::io_service * io(&ioService((ioWorker()<0)?0:ioWorker()));
+  offloadSubmit(std::move(work),std::move(completion),[io](asio_handler_t handler){
+    ::asio::post(*io,ioMonitorBind(std::move(handler),ioServiceIndex(*io)));
+  });
+}
+void ioServiceOffload(asio_handler_t work,error_handler_t completion){
+  ioServiceOffload(std::move(work),offloadHandler(std::move(completion)));
+}
+void ioServiceOffload(const connection::interface_ptr & ptr,asio_handler_t work,offload_handler_t completion){
+  offloadSubmit(std::move(work),std::move(completion),[ptr](asio_handler_t handler){
+    ptr->post(std::move(handler));
+  });
+}
+void ioServiceOffload(const connection::interface_ptr & ptr,asio_handler_t work,error_handler_t completion){
+  ioServiceOffload(ptr,std::move(work),offloadHandler(std::move(completion)));
+}
+//============================================
+}}
+//============================================
+#ifdef ENABLE_TESTING
+#include "test.hpp"
+#include <future>
+REGISTER_TEST(offload,tc1){
+  const std::thread::id main(std::this_thread::get_id());
+  std::atomic<int> work(0);
+  std::atomic<int> done(0);
+  std::atomic<int> busy(0);
+  std::atomic<int> failed(0);
+  std::atomic<bool> blocked(true);
+  ict::asio::ioOffloadConfig().threads=2;
+  ict::asio::ioOffloadConfig().capacity=8;
+  ict::asio::ioConfig().threads=1;
+  ict::asio::ioRun();
+  auto completion=[&](const ict::asio::error_code_t & ec){
+    if (ict::asio::ioWorker()<0) failed++;
+    if (ec.value()==EBUSY) busy++;
+    else if (ec) failed++;
+    done++;
+  };
+  //Zadania wykonywane poza wątkiem głównym i wątkami ioRun(), wynik w wątku ioRun().
+  for (int i=0;i<8;i++) ict::asio::ioServiceOffload([&](){
+    if ((std::this_thread::get_id()==main)||(0<=ict::asio::ioWorker())) failed++;
+    work++;
+  },completion);
+  for (int i=0;(i<10000)&&(done<8);i++) usleep(1000);
+  //Zablokowanie obu wątków puli i zapełnienie kolejek.
+  for (int i=0;i<2;i++) ict::asio::ioServiceOffload([&](){
+    while (blocked) usleep(1000);
+    work++;
+  },completion);
+  for (int i=0;(i<10000)&&(ict::asio::ioOffloadStats().running<2);i++) usleep(1000);
+  for (int i=0;i<8;i++) ict::asio::ioServiceOffload([&](){
+    work++;
+  },completion);
+  ict::asio::offload_stats_t s(ict::asio::ioOffloadStats());
+  ict::asio::ioServiceOffload([&](){
+    work++;
+  },completion);
+  blocked=false;
+  for (int i=0;(i<10000)&&(done<19);i++) usleep(1000);
+  //Zadanie zgłaszające wyjątek.
+  std::promise<ict::asio::error_code_t> p;
+  ict::asio::ioServiceOffload([](){
+    throw std::runtime_error("test");
+  },[&](const ict::asio::error_code_t & ec){
+    p.set_value(ec);
+  });
+  std::future<ict::asio::error_code_t> f(p.get_future());
+  const bool ready(f.wait_for(std::chrono::seconds(10))==std::future_status::ready);
+  //Wyjątek przekazany do funkcji zakończenia.
+  std::promise<std::string> e;
+  ict::asio::ioServiceOffload([](){
+    throw std::runtime_error("test");
+  },[&](const ict::asio::error_code_t & ec,std::exception_ptr ptr){
+    try {
+      if (ptr) std::rethrow_exception(ptr);
+      e.set_value("");
+    } catch (const std::runtime_error & r){
+      e.set_value((ec.value()==EFAULT)?r.what():"");
+    }
+  });
+  std::future<std::string> fe(e.get_future());
+  const bool ready_e(fe.wait_for(std::chrono::seconds(10))==std::future_status::ready);
+  ict::asio::ioStop();
+  ict::asio::ioJoin();
+  ict::asio::ioConfig().threads=0;
+  std::cout<<"queued="<<s.queued<<" running="<<s.running<<" completed="<<ict::asio::ioOffloadStats().completed<<" rejected="<<ict::asio::ioOffloadStats().rejected<<" stolen="<<ict::asio::ioOffloadStats().stolen<<std::endl;
+  if (failed) return(-1);
+  if (work!=18) return(-2);
+  if (busy!=1) return(-3);
+  if ((s.queued!=8)||(s.running!=2)||(s.capacity!=8)||(s.threads!=2)) return(-4);
+  if (!ready) return(-5);
+  if (f.get().value()!=EFAULT) return(-6);
+  if (ict::asio::ioOffloadStats().rejected!=1) return(-7);
+  if (!ready_e) return(-8);
+  if (fe.get()!="test") return(-9);
+  if (ict::asio::ioOffloadStats().queued!=0) return(-10);
+  return(0);
+}
+#endif
+//===========================================
@@ -0,0 +1,104 @@
+//! @file
+//! @brief ASIO offload module - header file.
+//! @author Mariusz Ornowski (mariusz.ornowski@ict-project.pl)
+//! @date 2020-2022
+//! @copyright ICT-Project Mariusz Ornowski (ict-project.pl)
+/* **************************************************************
+Copyright (c) 2020-2022, ICT-Project Mariusz Ornowski (ict-project.pl)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1. Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of the ICT-Project Mariusz Ornowski nor the names
+of its contributors may be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**************************************************************/
+#ifndef _ASIO_OFFLOAD_HEADER
+#define _ASIO_OFFLOAD_HEADER
+//============================================
+#include <cstddef>
+#include <exception>
+#include "types.hpp"
+#include "connection.hpp"
+//============================================
+namespace ict { namespace asio {
+//============================================
+//! Funkcja wywoływana po wykonaniu zadania - kod błędu i wyjątek zgłoszony przez zadanie (lub nullptr).
+typedef unique_function<void(const error_code_t&,std::exception_ptr)> offload_handler_t;
+//! Konfiguracja puli wątków do zadań obliczeniowych (musi być ustawiona przed pierwszym użyciem ioServiceOffload()).
+struct offload_config_t {
+  //! Liczba wątków (0 - std::thread::hardware_concurrency()).
+  unsigned int threads=0;
+  //! Maksymalna liczba zadań oczekujących w kolejkach (po jej przekroczeniu zadania są odrzucane z błędem EBUSY).
+  std::size_t capacity=1024;
+};
+//! Stan puli wątków do zadań obliczeniowych.
+struct offload_stats_t {
+  //! Liczba wątków.
+  std::size_t threads=0;
+  //! Maksymalna liczba zadań oczekujących w kolejkach.
+  std::size_t capacity=0;
+  //! Liczba zadań oczekujących w kolejkach.
+  std::size_t queued=0;
+  //! Liczba zadań w trakcie wykonania.
+  std::size_t running=0;
+  //! Liczba wykonanych zadań.
+  std::size_t completed=0;
+  //! Liczba odrzuconych zadań (pełne kolejki).
+  std::size_t rejected=0;
+  //! Liczba zadań przejętych z kolejek innych wątków.
+  std::size_t stolen=0;
+};
+//! Dostęp do konfiguracji puli wątków do zadań obliczeniowych.
+offload_config_t & ioOffloadConfig();
+//! Zwraca stan puli wątków do zadań obliczeniowych.
+offload_stats_t ioOffloadStats();
+//! Wykonuje zadanie w osobnej puli wątków (poza wątkami uruchomionymi przez ioRun()),
+//! a następnie przekazuje wynik do ::asio::io_service wątku, który zlecił zadanie (patrz ioWorker()).
+//! @param work Zadanie do wykonania.
+//! @param completion Funkcja wywoływana po wykonaniu zadania - kod błędu: EBUSY (kolejki są pełne, zadanie nie zostało wykonane),
+//!  EFAULT (zadanie zgłosiło wyjątek).
+void ioServiceOffload(asio_handler_t work,error_handler_t completion);
+//! Wykonuje zadanie w osobnej puli wątków (poza wątkami uruchomionymi przez ioRun()),
+//! a następnie przekazuje wynik do ::asio::io_service wątku, który zlecił zadanie (patrz ioWorker()).
+//! @param work Zadanie do wykonania.
+//! @param completion Funkcja wywoływana po wykonaniu zadania - kod błędu: EBUSY (kolejki są pełne, zadanie nie zostało wykonane),
+//!  EFAULT (zadanie zgłosiło wyjątek - przekazany w drugim parametrze).
+void ioServiceOffload(asio_handler_t work,offload_handler_t completion);
+//! Wykonuje zadanie w osobnej puli wątków (poza wątkami uruchomionymi przez ioRun()),
+//! a następnie przekazuje wynik do połączenia (patrz connection::interface::post()).
+//! @param ptr Połączenie, w ramach którego (::asio::strand) wywoływana jest funkcja completion.
+//! @param work Zadanie do wykonania.
+//! @param completion Funkcja wywoływana po wykonaniu zadania - kod błędu: EBUSY (kolejki są pełne, zadanie nie zostało wykonane),
+//!  EFAULT (zadanie zgłosiło wyjątek).
+void ioServiceOffload(const connection::interface_ptr & ptr,asio_handler_t work,error_handler_t completion);
+//! Wykonuje zadanie w osobnej puli wątków (poza wątkami uruchomionymi przez ioRun()),
+//! a następnie przekazuje wynik do połączenia (patrz connection::interface::post()).
+//! @param ptr Połączenie, w ramach którego (::asio::strand) wywoływana jest funkcja completion.
+//! @param work Zadanie do wykonania.
+//! @param completion Funkcja wywoływana po wykonaniu zadania - kod błędu: EBUSY (kolejki są pełne, zadanie nie zostało wykonane),
+//!  EFAULT (zadanie zgłosiło wyjątek - przekazany w drugim parametrze).
+void ioServiceOffload(const connection::interface_ptr & ptr,asio_handler_t work,offload_handler_t completion);
+//============================================
+}}
+//===========================================
+#endif
@@ -0,0 +1,283 @@
+//! @file
+//! @brief ASIO prefork module - Source file.
+//! @author Mariusz Ornowski (mariusz.ornowski@ict-project.pl)
+//! @date 2020-2022
+//! @copyright ICT-Project Mariusz Ornowski (ict-project.pl)
+/* **************************************************************
+Copyright (c) 2020-2022, ICT-Project Mariusz Ornowski (ict-project.pl)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1. Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of the ICT-Project Mariusz Ornowski nor the names
+of its contributors may be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**************************************************************/
+//============================================
+#include <atomic>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <cstdio>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "prefork.hpp"
+//============================================
+namespace ict { namespace asio {
+//============================================
+//! Stan trybu wieloprocesowego (dostępny z funkcji obsługi sygnałów).
+struct prefork_t {
+  volatile std::sig_atomic_t stop=0;
+  //! Liczba procesów roboczych (odczytywana w funkcji obsługi sygnałów).
+  std::atomic<std::size_t> size{0};
+  //! Identyfikatory procesów roboczych (0 - proces nie działa).
+  std::unique_ptr<std::atomic<pid_t>[]> pids;
+};
+static prefork_t & prefork(){
+  static prefork_t p;
+  return(p);
+}
+//! Numer procesu roboczego (-1 w procesie nadrzędnym).
+static int & preforkIndex(){
+  static int i(-1);
+  return(i);
+}
+static void preforkSignal(int signal){
+  ioPreforkStop();
+}
+prefork_config_t & ioPreforkConfig(){
+  static prefork_config_t c;
+  return(c);
+}
+void ioPreforkStop(){
+  prefork().stop=1;
+  for (std::size_t i=0;i<prefork().size;i++){
+    const pid_t pid(prefork().pids[i].load());
+    if (0<pid) ::kill(pid,SIGTERM);
+  }
+}
+int ioPreforkWorker(){
+  return(preforkIndex());
+}
+//! Uruchamia proces roboczy.
+//! @returns Identyfikator procesu lub -1 (błąd fork()).
+static pid_t preforkStart(unsigned int i,const prefork_handler_t & worker){
+  std::fflush(nullptr);
+  const pid_t pid(::fork());
+  if (pid==0){
+    std::signal(SIGINT,SIG_DFL);
+    std::signal(SIGTERM,SIG_DFL);
+    preforkIndex()=i;
+    prefork().size=0;
+    int r(-1);
+    try {
+      r=worker(i);
+    } catch (...) {
+    }
+    std::fflush(nullptr);
+    ::_exit(r);
+  }
+  if (0<pid) {
+    prefork().pids[i]=pid;
+    if (prefork().stop) ::kill(pid,SIGTERM);
+  }
+  return(pid);
+}
+//! Zgłasza nieprawidłowe zakończenie procesu roboczego.
+//! @returns Informacja, czy proces zakończył się nieprawidłowo.
+static bool preforkReport(std::size_t i,pid_t pid,int status){
+  //Zakończenie przez ioPreforkStop() jest prawidłowe.
+  if (prefork().stop&&WIFSIGNALED(status)&&(WTERMSIG(status)==SIGTERM)) return(false);
+  if (WIFSIGNALED(status)){
+    std::cerr<<__LINE__<<"|"<<"ict::asio::ioPrefork() - worker "<<i<<" (pid "<<pid<<") killed by signal|"<<WTERMSIG(status)<<std::endl;
+    return(true);
+  }
+  if (WIFEXITED(status)&&WEXITSTATUS(status)){
+    std::cerr<<__LINE__<<"|"<<"ict::asio::ioPrefork() - worker "<<i<<" (pid "<<pid<<") exited with status|"<<WEXITSTATUS(status)<<std::endl;
+    return(true);
+  }
+  return(false);
+}
+//! Zwraca czas oczekiwania przed ponownym uruchomieniem procesu roboczego.
+//! @param failures Liczba kolejnych nieprawidłowych zakończeń.
+static std::chrono::milliseconds preforkDelay(unsigned int failures){
+  std::chrono::milliseconds delay(ioPreforkConfig().restart);
+  for (unsigned int f=1;(f<failures)&&(delay<ioPreforkConfig().restart_max);f++) delay*=2;
+  return(std::min(delay,std::max(ioPreforkConfig().restart,ioPreforkConfig().restart_max)));
+}
+int ioPrefork(const prefork_handler_t & worker){
+  typedef std::chrono::steady_clock clock_t;
+  if (0<=preforkIndex()) return(-1);
+  std::size_t n(ioPreforkConfig().workers);
+  if (!n) n=std::thread::hardware_concurrency();
+  if (!n) n=1;
+  int r(0);
+  //Liczba kolejnych nieprawidłowych zakończeń i czas ponownego uruchomienia procesu roboczego.
+  std::vector<unsigned int> failures(n,0);
+  std::vector<clock_t::time_point> restart(n);
+  std::vector<bool> pending(n,false);
+  prefork().stop=0;
+  prefork().pids.reset(new std::atomic<pid_t>[n]);
+  for (std::size_t i=0;i<n;i++) prefork().pids[i]=0;
+  prefork().size=n;
+  struct sigaction action={},oldInt,oldTerm;
+  action.sa_handler=preforkSignal;
+  sigemptyset(&action.sa_mask);
+  ::sigaction(SIGINT,&action,&oldInt);
+  ::sigaction(SIGTERM,&action,&oldTerm);
+  for (std::size_t i=0;(i<n)&&!prefork().stop;i++) if (preforkStart(i,worker)<0){
+    r=-1;
+    ioPreforkStop();
+  }
+  for (;;){
+    //Ponowne uruchomienie procesów roboczych, dla których minął czas oczekiwania.
+    bool waiting(false);
+    for (std::size_t i=0;i<n;i++) if (pending[i]){
+      if (prefork().stop){
+        pending[i]=false;
+      } else if (restart[i]<=clock_t::now()){
+        pending[i]=false;
+        if (preforkStart(i,worker)<0){
+          r=-1;
+          ioPreforkStop();
+        }
+      } else {
+        waiting=true;
+      }
+    }
+    int status;
+    //Gdy procesy czekają na ponowne uruchomienie, waitpid() nie może blokować.
+    const pid_t pid(::waitpid(-1,&status,waiting?WNOHANG:0));
+    if (pid==0||(pid<0&&errno==ECHILD&&waiting)){
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      continue;
+    }
+    if (pid<0){
+      if (errno==EINTR) continue;
+      break;
+    }
+    for (std::size_t i=0;i<n;i++) if (prefork().pids[i]==pid){
+      prefork().pids[i]=0;
+      if (preforkReport(i,pid,status)) failures[i]++; else failures[i]=0;
+      if (prefork().stop) continue;
+      if (ioPreforkConfig().restart_limit&&(ioPreforkConfig().restart_limit<=failures[i])){
+        std::cerr<<__LINE__<<"|"<<"ict::asio::ioPrefork() - worker "<<i<<" not restarted after failures|"<<failures[i]<<std::endl;
+        r=-1;
+        continue;
+      }
+      restart[i]=clock_t::now()+preforkDelay(failures[i]);
+      pending[i]=true;
+    }
+  }
+  ::sigaction(SIGINT,&oldInt,nullptr);
+  ::sigaction(SIGTERM,&oldTerm,nullptr);
+  prefork().size=0;
+  return(r);
+}
+//============================================
+}}
+//============================================
+#ifdef ENABLE_TESTING
+#include "test.hpp"
+#include <new>
+#include <sys/mman.h>
+#include "asio.hpp"
+#include "connector.hpp"
+REGISTER_TEST(prefork,tc1){
+  struct shared_t {
+    std::atomic<int> starts{0};
+    std::atomic<int> bound{0};
+  };
+  void * memory(::mmap(nullptr,sizeof(shared_t),PROT_READ|PROT_WRITE,MAP_SHARED|MAP_ANONYMOUS,-1,0));
+  if (memory==MAP_FAILED) return(-1);
+  shared_t * shared(new(memory) shared_t());
+  srand(time(NULL));
+  const std::string port("303"+std::to_string(rand()%90+10));
+  ict::asio::ioPreforkConfig().workers=2;
+  ict::asio::ioPreforkConfig().restart=std::chrono::milliseconds(10);
+  std::thread stop([shared](){
+    for (int i=0;(i<20000)&&(shared->bound<4);i++) usleep(1000);
+    ict::asio::ioPreforkStop();
+  });
+  const int r(ict::asio::ioPrefork([shared,port](unsigned int worker){
+    const int n(shared->starts++);
+    if (ict::asio::ioPreforkWorker()!=(int)worker) return(1);
+    ict::asio::connector::interface_ptr s(ict::asio::connector::get("localhost",port,true));
+    s->async_connection([](const ict::asio::error_code_t& ec,ict::asio::connection::interface_ptr ptr){});
+    ict::asio::ioSignal();
+    ict::asio::ioRun();
+    bool open(false);
+    for (int i=0;(i<1000)&&!(open=s->is_open())&&!s->is_error();i++) usleep(1000);
+    if (open) shared->bound++;
+    if (n<2){
+      //Pierwsze procesy nasłuchują na tym samym porcie jednocześnie, a następnie kończą się (i są uruchamiane ponownie).
+      for (int i=0;(i<10000)&&(shared->bound<2);i++) usleep(1000);
+      s->close();
+      usleep(10000);
+      ict::asio::ioStop();
+      ict::asio::ioJoin();
+      return(1);
+    }
+    ict::asio::ioJoin();
+    return(0);
+  }));
+  stop.join();
+  int out(0);
+  if (r) out=-2;
+  else if (ict::asio::ioPreforkWorker()!=-1) out=-3;
+  else if (shared->starts<4) out=-4;
+  else if (shared->bound<4) out=-5;
+  shared->~shared_t();
+  ::munmap(memory,sizeof(shared_t));
+  return(out);
+}
+REGISTER_TEST(prefork,tc2){
+  std::atomic<int> * starts(static_cast<std::atomic<int>*>(::mmap(nullptr,sizeof(std::atomic<int>),PROT_READ|PROT_WRITE,MAP_SHARED|MAP_ANONYMOUS,-1,0)));
+  if (starts==MAP_FAILED) return(-1);
+  new(starts) std::atomic<int>(0);
+  ict::asio::ioPreforkConfig().workers=1;
+  ict::asio::ioPreforkConfig().restart=std::chrono::milliseconds(5);
+  ict::asio::ioPreforkConfig().restart_max=std::chrono::milliseconds(20);
+  ict::asio::ioPreforkConfig().restart_limit=4;
+  const auto start(std::chrono::steady_clock::now());
+  //Proces roboczy kończy się sygnałem - po restart_limit kolejnych zakończeniach nie jest uruchamiany ponownie.
+  const int r(ict::asio::ioPrefork([starts](unsigned int worker){
+    (*starts)++;
+    ::raise(SIGKILL);
+    return(0);
+  }));
+  const auto elapsed(std::chrono::steady_clock::now()-start);
+  const int n(*starts);
+  ::munmap(starts,sizeof(std::atomic<int>));
+  ict::asio::ioPreforkConfig()=ict::asio::prefork_config_t();
+  if (r!=-1) return(-2);
+  if (n!=4) return(-3);
+  //Oczekiwanie: 5ms, 10ms, 20ms.
+  if (elapsed<std::chrono::milliseconds(35)) return(-4);
+  return(0);
+}
+#endif
+//===========================================
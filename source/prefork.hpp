@@ -0,0 +1,80 @@
+//! @file
+//! @brief ASIO prefork module - header file.
+//! @author Mariusz Ornowski (mariusz.ornowski@ict-project.pl)
+//! @date 2020-2022
+//! @copyright ICT-Project Mariusz Ornowski (ict-project.pl)
+/* **************************************************************
+Copyright (c) 2020-2022, ICT-Project Mariusz Ornowski (ict-project.pl)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+
+1. Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+2. Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+3. Neither the name of the ICT-Project Mariusz Ornowski nor the names
+of its contributors may be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+"AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+**************************************************************/
+#ifndef _ASIO_PREFORK_HEADER
+#define _ASIO_PREFORK_HEADER
+//============================================
+#include <chrono>
+#include <functional>
+#include "types.hpp"
+//============================================
+namespace ict { namespace asio {
+//============================================
+//! Konfiguracja trybu wieloprocesowego (musi być ustawiona przed ioPrefork()).
+struct prefork_config_t {
+  //! Liczba procesów roboczych (0 - std::thread::hardware_concurrency()).
+  unsigned int workers=0;
+  //! Czas oczekiwania przed ponownym uruchomieniem procesu roboczego, który się zakończył.
+  //! Po każdym kolejnym nieprawidłowym zakończeniu (sygnał lub kod wyjścia różny od 0) czas jest podwajany (do restart_max).
+  std::chrono::milliseconds restart=std::chrono::milliseconds(100);
+  //! Maksymalny czas oczekiwania przed ponownym uruchomieniem procesu roboczego.
+  std::chrono::milliseconds restart_max=std::chrono::milliseconds(30000);
+  //! Liczba kolejnych nieprawidłowych zakończeń, po której proces roboczy nie jest uruchamiany ponownie (0 - bez ograniczenia).
+  unsigned int restart_limit=10;
+};
+//! Funkcja wykonywana w procesie roboczym (zwracana wartość jest kodem wyjścia procesu).
+//! @param worker Numer procesu roboczego (od 0 do prefork_config_t::workers-1).
+typedef std::function<int(unsigned int)> prefork_handler_t;
+//! Dostęp do konfiguracji trybu wieloprocesowego.
+prefork_config_t & ioPreforkConfig();
+//! Uruchamia procesy robocze (fork()) i nadzoruje je - proces roboczy, który się zakończył, jest uruchamiany ponownie.
+//! Każdy proces roboczy ma własne ::asio::io_service, locki i brokery, a serwery TCP (patrz connector::get()) używają SO_REUSEPORT,
+//! więc połączenia są rozdzielane przez jądro systemu pomiędzy procesy.
+//! Uwaga: Musi być wywołane przed pierwszym użyciem ioService() i ioRun() w procesie nadrzędnym.
+//! Sygnały SIGINT i SIGTERM w procesie nadrzędnym (lub ioPreforkStop()) kończą wszystkie procesy robocze (SIGTERM).
+//! @param worker Funkcja wykonywana w procesie roboczym (powinna utworzyć konektory, wywołać ioRun() i ioJoin()).
+//! Nieprawidłowe zakończenie procesu roboczego (sygnał lub kod wyjścia różny od 0) jest zgłaszane na std::cerr.
+//! @returns W procesie nadrzędnym (po zakończeniu wszystkich procesów roboczych): 0 lub -1 (błąd fork(), przekroczenie restart_limit
+//!  lub wywołanie w procesie roboczym).
+//!  W procesie roboczym funkcja nie wraca.
+int ioPrefork(const prefork_handler_t & worker);
+//! Kończy tryb wieloprocesowy (wysyła SIGTERM do procesów roboczych, które nie będą uruchamiane ponownie).
+void ioPreforkStop();
+//! Zwraca numer procesu roboczego, w którym wykonywany jest kod.
+//! @returns Numer procesu roboczego lub -1, gdy kod nie jest wykonywany w procesie roboczym uruchomionym przez ioPrefork().
+int ioPreforkWorker();
+//============================================
+}}
+//===========================================
+#endif
@@ -57,7 +57,7 @@ private:
   //! Czy wykonano handler
   bool done=false;
   //! Strand dla handler
-  ::asio::io_service::strand s;
+  ict::asio::strand_t s;
   //! Endpoint
   tcp_endpoint_info_ptr endpoint;
   //! Wykonanie handler
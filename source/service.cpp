@@ -33,21 +33,293 @@ THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 **************************************************************/
 //============================================
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <system_error>
 #include <asio.hpp>
+#include "asio.hpp"
 #include "service.h"
 //============================================
 namespace ict { namespace asio {
 //============================================
+//! Element puli - ::asio::io_service wraz z licznikiem połączeń.
+struct slot_t {
+  ::asio::io_service io;
+  ::asio::executor_work_guard<::asio::io_service::executor_type> wg;
+  std::atomic<std::size_t> load{0};
+  lanes_t lanes;
+  slot_t(int hint):io(hint),wg(::asio::make_work_guard(io)){}
+};
+typedef std::vector<std::unique_ptr<slot_t>> pool_t;
+//! Ustawienia puli.
+struct pool_config_t {
+  std::atomic<bool> created{false};
+  std::size_t size=1;
+  balance_t balance=round_robin;
+  bool single=false;
+  std::atomic<std::size_t> next{0};
+};
+static pool_config_t & poolConfig(){
+  static pool_config_t c;
+  return(c);
+}
+static pool_t poolCreate(){
+  pool_t p;
+#if defined(ASIO_HAS_IO_URING_AS_DEFAULT)
+  if (!ioUringSupported()) throw std::system_error(ENOSYS,std::generic_category(),"io_uring is not supported by the kernel (library built with ICT_ASIO_IO_URING=ON)");
+#endif
+  poolConfig().created=true;
+  const int hint(poolConfig().single?ASIO_CONCURRENCY_HINT_UNSAFE_IO:ASIO_CONCURRENCY_HINT_DEFAULT);
+  for (std::size_t i=0;i<poolConfig().size;i++) p.emplace_back(new slot_t(hint));
+  return(p);
+}
+static pool_t & pool(){
+  static pool_t p(poolCreate());
+  return(p);
+}
+//! Zwraca liczbę wątków obsługujących jeden ::asio::io_service z puli (patrz ioRun()).
+static std::size_t poolThreads(){
+  if (poolConfig().single) return(1);
+  std::size_t n(ioConfig().threads);
+  if (!n) n=(1<pool().size())?pool().size():std::thread::hardware_concurrency();
+  if (!n) n=1;
+  return((n+pool().size()-1)/pool().size());
+}
+static slot_t * poolSlot(const ::asio::io_service & io){
+  for (const auto & slot : pool()) if (&(slot->io)==&io) return(slot.get());
+  return(nullptr);
+}
+//============================================
 ::asio::io_service & ioService(){
-  static ::asio::io_service io;
-  static auto wg=::asio::make_work_guard(io);
-  return(io);
+  return(pool().front()->io);
+}
+::asio::io_service & ioService(std::size_t index){
+  return(pool().at(index%pool().size())->io);
+}
+bool ioServicePool(std::size_t size,balance_t balance){
+  if (poolConfig().created) return(false);
+  poolConfig().size=size?size:1;
+  poolConfig().balance=balance;
+  return(true);
+}
+bool ioServiceSingle(bool single){
+  if (poolConfig().created) return(false);
+  poolConfig().single=single;
+  return(true);
+}
+bool ioServiceIsSingle(){
+  return(poolConfig().single);
+}
+std::size_t ioServiceSize(){
+  return(pool().size());
+}
+::asio::io_service & ioServiceNext(){
+  const pool_t & p(pool());
+  if (p.size()<2) return(p.front()->io);
+  switch(poolConfig().balance){
+    case least_loaded:{
+      std::size_t k=0;
+      for (std::size_t i=1;i<p.size();i++) if (p.at(i)->load<p.at(k)->load) k=i;
+      return(p.at(k)->io);
+    }
+    default:break;
+  }
+  return(p.at((poolConfig().next++)%p.size())->io);
+}
+std::size_t ioServiceIndex(const ::asio::io_service & io){
+  const pool_t & p(pool());
+  for (std::size_t i=0;i<p.size();i++) if (&(p.at(i)->io)==&io) return(i);
+  return(p.size());
+}
+void ioServiceAttach(const ::asio::io_service & io){
+  if (slot_t * slot=poolSlot(io)) slot->load++;
+}
+void ioServiceDetach(const ::asio::io_service & io){
+  if (slot_t * slot=poolSlot(io)) slot->load--;
+}
+std::size_t ioServiceLoad(std::size_t index){
+  return(pool().at(index%pool().size())->load);
+}
+void lanes_t::push(priority_t priority,asio_handler_t handler){
+  std::lock_guard<std::mutex> lock(mutex);
+  queues[priority].push_back(std::move(handler));
+}
+asio_handler_t lanes_t::pop(priority_t priority){
+  std::lock_guard<std::mutex> lock(mutex);
+  asio_handler_t handler;
+  if (!queues[priority].empty()){
+    handler=std::move(queues[priority].front());
+    queues[priority].pop_front();
+  }
+  return(handler);
+}
+asio_handler_t lanes_t::pop(){
+  std::lock_guard<std::mutex> lock(mutex);
+  asio_handler_t handler;
+  for (int round=0;round<2;round++){
+    for (std::size_t i=0;i<=bulk_priority;i++) if (credits[i]&&!queues[i].empty()){
+      credits[i]--;
+      handler=std::move(queues[i].front());
+      queues[i].pop_front();
+      return(handler);
+    }
+    for (std::size_t i=0;i<=bulk_priority;i++) credits[i]=ioConfig().weights.at(i)?ioConfig().weights.at(i):1;
+  }
+  return(handler);
+}
+void ioServicePost(::asio::io_service & io,priority_t priority,asio_handler_t handler){
+  const pool_t & p(pool());
+  for (std::size_t i=0;i<p.size();i++) if (&(p.at(i)->io)==&io){
+    slot_t * slot(p.at(i).get());
+    slot->lanes.push(priority,std::move(handler));
+    ::asio::post(io,ioMonitorBind([slot](){
+      if (asio_handler_t h=slot->lanes.pop()) h();
+    },i));
+    return;
+  }
+  ::asio::post(io,ioMonitorBind(std::move(handler),ioServiceIndex(io)));
+}
+//! Zadania dodane jedną operacją.
+struct batch_t {
+  std::vector<asio_handler_t> handlers;
+  //! Następne zadanie do wykonania.
+  std::atomic<std::size_t> next{0};
+};
+void ioServicePost(::asio::io_service & io,std::vector<asio_handler_t> handlers){
+  if (handlers.empty()) return;
+  std::shared_ptr<batch_t> batch(std::make_shared<batch_t>());
+  batch->handlers=std::move(handlers);
+  const std::size_t tokens(std::min(batch->handlers.size(),poolThreads()));
+  const std::size_t index(ioServiceIndex(io));
+  for (std::size_t t=0;t<tokens;t++) ::asio::post(io,ioMonitorBind([batch](){
+    for (std::size_t i=batch->next++;i<batch->handlers.size();i=batch->next++) batch->handlers[i]();
+  },index));
 }
 //============================================
 }}
 //============================================
 #ifdef ENABLE_TESTING
 #include "test.hpp"
-
+#include "asio.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <unistd.h>
+#include <sys/wait.h>
+//! Mierzy koszt zadania dodanego przez strand_t::post() (w bieżącym trybie puli - najlepszy z kilku pomiarów).
+//! @returns Czas jednego zadania w ns.
+static double test__strand(){
+  const std::size_t n(1000000);
+  double best(0);
+  ict::asio::strand_t strand(ict::asio::ioService());
+  for (int round=0;round<3;round++){
+    std::size_t k(0);
+    std::function<void()> step;
+    step=[&](){
+      if (++k<n) strand.post(step);
+      else ict::asio::ioStop();
+    };
+    ict::asio::ioService().restart();
+    const auto start(std::chrono::steady_clock::now());
+    strand.post(step);
+    ict::asio::ioService().run();
+    const double t(std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now()-start).count()/n);
+    if ((!round)||(t<best)) best=t;
+  }
+  return(best);
+}
+REGISTER_TEST(service,tc1){
+  //Tryb jednowątkowy można włączyć tylko przed utworzeniem puli - pomiar w procesie potomnym.
+  int fds[2];
+  if (::pipe(fds)) return(-1);
+  const pid_t pid(::fork());
+  if (pid<0) return(-2);
+  if (!pid){
+    ::close(fds[0]);
+    const double t(ict::asio::ioServiceSingle()?test__strand():-1);
+    const bool ok(::write(fds[1],&t,sizeof(t))==sizeof(t));
+    ::_exit(ok?0:1);
+  }
+  ::close(fds[1]);
+  double single(-1);
+  const bool ok(::read(fds[0],&single,sizeof(single))==sizeof(single));
+  ::close(fds[0]);
+  int status(0);
+  ::waitpid(pid,&status,0);
+  if (!ok||(single<0)) return(-3);
+  if (ict::asio::ioServiceIsSingle()) return(-4);
+  const double multi(test__strand());
+  std::cout<<"strand_t::post() - pool: "<<multi<<" ns/op"<<std::endl;
+  std::cout<<"strand_t::post() - ioServiceSingle(): "<<single<<" ns/op"<<std::endl;
+  std::cout<<"saving: "<<(multi-single)<<" ns/op"<<std::endl;
+  //Tryb jednowątkowy (bez ::asio::strand i blokad io_service) nie może być wolniejszy.
+  if (multi<single) return(-5);
+  return(0);
+}
+REGISTER_TEST(service,tc2){
+  std::atomic<int> out(0);
+  std::atomic<int> workers(0);
+  const int n(100);
+  if (!ict::asio::ioServiceSingle()) return(-1);
+  if (!ict::asio::ioServiceIsSingle()) return(-2);
+  ict::asio::strand_t strand(ict::asio::ioService());
+  ict::asio::ioRun([&](){
+    workers++;
+    ict::asio::ioServiceRun();
+  });
+  for (int i=0;i<n;i++) strand.post([&out,i,n](){
+    if (out==i) out++;
+    if (out==n) ict::asio::ioStop();
+  });
+  ict::asio::ioJoin();
+  if (workers!=1) return(-3);
+  if (out!=n) return(-4);
+  return(0);
+}
+REGISTER_TEST(service,tc3){
+  std::vector<ict::asio::priority_t> order;
+  std::vector<int> strandOrder;
+  std::mutex mutex;
+  const int n(20);
+  ict::asio::ioConfig().threads=1;
+  ict::asio::strand_t strand(ict::asio::ioService());
+  //Zadania dodane przed ioRun() - wykonanie zależy tylko od wag kolejek.
+  for (const ict::asio::priority_t priority : {ict::asio::bulk_priority,ict::asio::normal_priority,ict::asio::high_priority}){
+    for (int i=0;i<n;i++) ict::asio::ioServicePost(priority,[&,priority](){
+      std::lock_guard<std::mutex> lock(mutex);
+      order.push_back(priority);
+    });
+  }
+  for (int i=0;i<n;i++) strand.post((i%2)?ict::asio::bulk_priority:ict::asio::high_priority,[&,i](){
+    std::lock_guard<std::mutex> lock(mutex);
+    strandOrder.push_back(i);
+  });
+  ict::asio::ioRun();
+  for (int i=0;i<10000;i++){
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if ((order.size()==3*n)&&(strandOrder.size()==n)) break;
+    }
+    usleep(1000);
+  }
+  ict::asio::ioStop();
+  ict::asio::ioJoin();
+  if (order.size()!=3*n) return(-1);
+  if (strandOrder.size()!=n) return(-2);
+  for (int i=0;i<16;i++) if (order.at(i)!=ict::asio::high_priority) return(-3);
+  for (int i=16;i<20;i++) if (order.at(i)!=ict::asio::normal_priority) return(-4);
+  if (order.at(20)!=ict::asio::bulk_priority) return(-5);
+  //Zadania w ramach strand_t wykonywane są w kolejności dodania w obrębie priorytetu.
+  int high(-2),bulk(-1);
+  for (const int i : strandOrder){
+    int & last((i%2)?bulk:high);
+    if (i<=last) return(-6);
+    last=i;
+  }
+  return(0);
+}
 #endif
 //===========================================
\ No newline at end of file
@@ -35,12 +35,186 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef _ASIO_SERVICE_HEADER
 #define _ASIO_SERVICE_HEADER
 //============================================
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <optional>
 #include <asio/io_service.hpp>
+#include <asio/io_context_strand.hpp>
+#include <asio/post.hpp>
+#include <asio/dispatch.hpp>
+#include <asio/bind_executor.hpp>
+#include "types.hpp"
+#include "memory.hpp"
+#include "monitor.hpp"
 //============================================
 namespace ict { namespace asio {
 //============================================
-//! Dostęp do ::asio::io_service
+//! Sposób wyboru ::asio::io_service z puli dla nowych połączeń.
+enum balance_t {
+  round_robin, //!< Kolejno (po kolei).
+  least_loaded //!< Ten, który obsługuje najmniej połączeń.
+};
+//! Dostęp do ::asio::io_service (domyślny - pierwszy w puli)
 ::asio::io_service & ioService();
+//! Dostęp do ::asio::io_service z puli
+//! @param index Numer ::asio::io_service w puli (modulo rozmiar puli).
+::asio::io_service & ioService(std::size_t index);
+//! Ustawia rozmiar puli ::asio::io_service (jeden ::asio::io_service na wątek).
+//! Uwaga: Musi być wywołane przed pierwszym użyciem ioService().
+//! @param size Liczba ::asio::io_service w puli (0 lub 1 - jeden wspólny ::asio::io_service).
+//! @param balance Sposób wyboru ::asio::io_service dla nowych połączeń.
+//! @returns Wartość true, jeśli ustawienie zostało przyjęte (pula nie była jeszcze utworzona).
+bool ioServicePool(std::size_t size,balance_t balance=round_robin);
+//! Zwraca liczbę ::asio::io_service w puli.
+std::size_t ioServiceSize();
+//! Wybiera ::asio::io_service z puli dla nowego połączenia.
+::asio::io_service & ioServiceNext();
+//! Zwraca numer ::asio::io_service w puli.
+//! @param io Obiekt ::asio::io_service.
+//! @returns Numer ::asio::io_service w puli lub ioServiceSize(), gdy nie należy do puli.
+std::size_t ioServiceIndex(const ::asio::io_service & io);
+//! Zwraca ::asio::io_service, z którym związany jest obiekt (gniazdo, timer itp.).
+//! @param object Obiekt ASIO.
+template<class Object> ::asio::io_service & ioServiceOf(Object & object){
+  return(static_cast<::asio::io_service&>(object.get_executor().context()));
+}
+//! Włącza tryb jednowątkowy - każdy ::asio::io_service jest obsługiwany przez dokładnie jeden wątek,
+//! jest tworzony z ASIO_CONCURRENCY_HINT_UNSAFE_IO, a strand_t przekazuje zadania bezpośrednio do ::asio::io_service.
+//! Uwaga: Musi być wywołane przed pierwszym użyciem ioService().
+//! @param single Informacja, czy tryb jednowątkowy ma być włączony.
+//! @returns Wartość true, jeśli ustawienie zostało przyjęte (pula nie była jeszcze utworzona).
+bool ioServiceSingle(bool single=true);
+//! Sprawdza, czy włączony jest tryb jednowątkowy.
+bool ioServiceIsSingle();
+//! Kolejki zadań dla kolejnych priorytetów (patrz priority_t).
+class lanes_t {
+private:
+  std::mutex mutex;
+  std::deque<asio_handler_t> queues[bulk_priority+1];
+  unsigned int credits[bulk_priority+1]={};
+public:
+  //! Dodaje zadanie do kolejki.
+  //! @param priority Priorytet zadania.
+  //! @param handler Zadanie.
+  void push(priority_t priority,asio_handler_t handler);
+  //! Pobiera pierwsze zadanie z kolejki.
+  //! @param priority Priorytet zadania.
+  //! @returns Zadanie (puste, gdy kolejka jest pusta).
+  asio_handler_t pop(priority_t priority);
+  //! Pobiera zadanie z kolejki o najwyższym priorytecie, która nie wyczerpała limitu (patrz io_config_t::weights).
+  //! Gdy wszystkie niepuste kolejki wyczerpały limit, limity są odnawiane.
+  //! @returns Zadanie (puste, gdy wszystkie kolejki są puste).
+  asio_handler_t pop();
+};
+//! Dodaje zadanie do kolejki o podanym priorytecie dla ::asio::io_service z puli - w kolejce ::asio::io_service umieszczane jest
+//! zadanie, które wykonuje następne zadanie z kolejek priorytetów (patrz lanes_t::pop()).
+//! @param io Obiekt ::asio::io_service (spoza puli - zadanie trafia bezpośrednio do ::asio::io_service).
+//! @param priority Priorytet zadania.
+//! @param handler Zadanie do wykonania.
+void ioServicePost(::asio::io_service & io,priority_t priority,asio_handler_t handler);
+//! Dodaje wiele zadań do ::asio::io_service jedną operacją (patrz ioServicePost(std::vector<asio_handler_t>)).
+//! @param io Obiekt ::asio::io_service.
+//! @param handlers Lista zadań.
+void ioServicePost(::asio::io_service & io,std::vector<asio_handler_t> handlers);
+//! Odpowiednik ::asio::io_service::strand - w trybie jednowątkowym zadania trafiają bezpośrednio do ::asio::io_service.
+//! Do każdego zadania przypisywany jest alokator memory_allocator_t oraz pomiar czasu wykonania (patrz ioMonitorBind()).
+class strand_t {
+private:
+  ::asio::io_service & io;
+  std::size_t index;
+  std::optional<::asio::io_service::strand> strand;
+  //! Priorytet zadań dodawanych przez post() (-1 - bez kolejek priorytetów).
+  std::atomic<int> priority{-1};
+  //! Kolejki zadań (zachowują kolejność zadań w ramach ::asio::strand).
+  std::shared_ptr<lanes_t> lanes;
+  std::once_flag once;
+public:
+  //! Konstruktor.
+  //! @param i Obiekt ::asio::io_service.
+  explicit strand_t(::asio::io_service & i):io(i),index(ioServiceIndex(i)){
+    if (!ioServiceIsSingle()) strand.emplace(io);
+  }
+  //! Dodaje zadanie do wykonania (odpowiednik ::asio::io_service::strand::post()).
+  //! Jeśli ustawiony jest priorytet (patrz set_priority()), zadanie trafia do kolejki tego priorytetu.
+  //! @param handler Zadanie do wykonania.
+  template<class Handler> void post(Handler && handler){
+    const int p(priority);
+    if (0<=p){
+      post(static_cast<priority_t>(p),std::forward<Handler>(handler));
+    } else if (strand){
+      ::asio::post(*strand,ioMonitorBind(std::forward<Handler>(handler),index));
+    } else {
+      ::asio::post(io,ioMonitorBind(std::forward<Handler>(handler),index));
+    }
+  }
+  //! Dodaje zadanie do wykonania w kolejce o podanym priorytecie (patrz ioServicePost()).
+  //! @param priority Priorytet zadania.
+  //! @param handler Zadanie do wykonania.
+  template<class Handler> void post(priority_t priority,Handler && handler){
+    if (!strand){
+      ioServicePost(io,priority,asio_handler_t(std::forward<Handler>(handler)));
+      return;
+    }
+    std::call_once(once,[this](){
+      lanes=std::make_shared<lanes_t>();
+    });
+    lanes->push(priority,asio_handler_t(std::forward<Handler>(handler)));
+    ioServicePost(io,priority,[s=*strand,l=lanes,priority,i=index]() mutable {
+      //Zadanie może trafić do kolejki ::asio::strand - pomiar czasu wykonania jest przypisywany osobno.
+      ::asio::dispatch(s,ioMonitorBind([l,priority](){
+        if (asio_handler_t h=l->pop(priority)) h();
+      },i));
+    });
+  }
+  //! Przypisuje funkcję zakończenia operacji ASIO do ::asio::strand (w trybie jednowątkowym - tylko pomiar czasu wykonania)
+  //! i przekazuje ją do funkcji uruchamiającej operację.
+  //! Funkcja zakończenia nie jest liczona jako zadanie w kolejce (jak dla zegarów) - operacja może czekać dowolnie długo.
+  //! @param handler Funkcja zakończenia operacji.
+  //! @param start Funkcja uruchamiająca operację ASIO.
+  template<class Handler,class Start> void bind(Handler && handler,Start && start){
+    if (strand){
+      start(::asio::bind_executor(*strand,ioMonitorBind(std::forward<Handler>(handler))));
+    } else {
+      start(ioMonitorBind(std::forward<Handler>(handler)));
+    }
+  }
+  //! Ustawia priorytet zadań dodawanych przez post().
+  //! @param p Priorytet.
+  void set_priority(priority_t p){
+    priority=p;
+  }
+  //! Zwraca priorytet zadań dodawanych przez post() (brak - zadania trafiają bezpośrednio do ::asio::io_service).
+  std::optional<priority_t> get_priority() const {
+    const int p(priority);
+    if (p<0) return(std::nullopt);
+    return(static_cast<priority_t>(p));
+  }
+  //! Wykonuje zadanie (odpowiednik ::asio::io_service::strand::dispatch()).
+  //! @param handler Zadanie do wykonania.
+  template<class Handler> void dispatch(Handler && handler){
+    if (strand){
+      ::asio::dispatch(*strand,ioMonitorBind(std::forward<Handler>(handler),index));
+    } else {
+      ::asio::dispatch(io,ioMonitorBind(std::forward<Handler>(handler),index));
+    }
+  }
+  //! Zwraca obiekt ::asio::io_service.
+  ::asio::io_service & context() const {
+    return(io);
+  }
+};
+//! Zwiększa licznik połączeń obsługiwanych przez ::asio::io_service.
+void ioServiceAttach(const ::asio::io_service & io);
+//! Zmniejsza licznik połączeń obsługiwanych przez ::asio::io_service.
+void ioServiceDetach(const ::asio::io_service & io);
+//! Zwraca licznik połączeń obsługiwanych przez ::asio::io_service.
+//! @param index Numer ::asio::io_service w puli.
+std::size_t ioServiceLoad(std::size_t index);
 //============================================
 }}
 //===========================================
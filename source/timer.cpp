@@ -52,7 +52,7 @@ const static std::string _both_("both");
 //============================================
 class Timer: public interface{
 private:
-    ::asio::io_context::strand strand;
+    ict::asio::strand_t strand;
     ::asio::system_timer system_timer;
     ::asio::steady_timer steady_timer;
     duration_t duration;
@@ -75,7 +75,10 @@ private:
     void set(const time_point_t & tp,const duration_t & du);
     void set(const date_time_t & dt,const duration_t & du);
     void set(const interface_ptr & ref,const duration_t & du);
-    void async_wait(const handler_t & h);
+    void async_wait(handler_t h);
+    void set_priority(priority_t priority){
+        strand.set_priority(priority);
+    }
     void cancel();
     void cancel(error_code_t& ec);
 public:
@@ -149,7 +152,7 @@ interface_ptr get(const date_time_t & dt,const duration_t & du){
     return ptr;
 }
 //============================================
-#define TIMER_WAIT(timer) timer.async_wait([self,this](const error_code_t& ec){exec(ec);})
+#define TIMER_WAIT(timer) timer.async_wait(ioMonitorBind([self,this](const error_code_t& ec){exec(ec);}))
 void Timer::exec(const error_code_t& ec){
     auto self(enable_shared_t::shared_from_this());
     strand.post([self,this,ec](){
@@ -217,7 +220,7 @@ void Timer::set(const time_point_t & tp,const duration_t & du){
         if ((now_system+std::chrono::seconds(1))<tp){
             reset(both);
             system_timer.expires_at(tp);
-            system_timer.async_wait([self,this,du](const error_code_t& ec){
+            system_timer.async_wait(ioMonitorBind([self,this,du](const error_code_t& ec){
                 strand.post([self,this,ec](){
                     if (ec){
                         exec(ec);
@@ -226,7 +229,7 @@ void Timer::set(const time_point_t & tp,const duration_t & du){
                         TIMER_WAIT(steady_timer);
                     }
                 });
-            });
+            }));
         } else {
             reset(steady);
             steady_timer.expires_at(std::chrono::steady_clock::now()+du-(now_system-tp));
@@ -262,10 +265,10 @@ void Timer::set(const interface_ptr & ref,const duration_t & du){
         } break; 
     }
 }
-void Timer::async_wait(const handler_t & h){
+void Timer::async_wait(handler_t h){
     auto self(enable_shared_t::shared_from_this());
-    strand.post([self,this,h](){
-        handlers.push(h);
+    strand.post([self,this,h=std::move(h)]() mutable {
+        handlers.push(std::move(h));
         if (expired) {
             error_code_t ec;
             exec(ec);
@@ -489,4 +492,25 @@ REGISTER_TEST(timer,tc10){
     if ((std::chrono::seconds(dur+1))<(tp_stop-tp_start)) out=-3;
     return out;
 }
+REGISTER_TEST(timer,tc11){
+    std::atomic<int> out=-1;
+    ict::asio::ioSignal();
+    ict::asio::ioRun();
+    {
+        std::unique_ptr<int> value(new int(11));
+        ict::asio::timer::interface_ptr ptr=ict::asio::timer::get(std::chrono::milliseconds(100));
+        ptr->async_wait([&out,value=std::move(value)](const ict::asio::error_code_t& ec){
+            if (ec){
+                out=1;
+            } else if (!value||(*value!=11)) {
+                out=2;
+            } else {
+                out=0;
+            }
+            ict::asio::ioStop();
+        });
+    }
+    ict::asio::ioJoin();
+    return out;
+}
 #endif
\ No newline at end of file
@@ -77,7 +77,7 @@ public:
   //! Typ pomocniczy do generowania wskaźnika.
   typedef  std::enable_shared_from_this<interface> enable_shared_t;
   //! Typ - Funkcja do obsługi timera.
-  typedef std::function<void(const ict::asio::error_code_t&)> handler_t;
+  typedef unique_function<void(const ict::asio::error_code_t&)> handler_t;
   //! Metadane timera
   map_info_t info;
   std::string getInfo(){
@@ -137,7 +137,10 @@ public:
   //! 
   //! @param h Zadanie do wykonania.
   //! 
-  virtual void async_wait(const handler_t & h)=0;
+  virtual void async_wait(handler_t h)=0;
+  //! Ustawia priorytet zadań timera (patrz ioServicePost()).
+  //! @param priority Priorytet.
+  virtual void set_priority(priority_t priority)=0;
   //! Anuluje wszystkie asynchroniczne operacje w timerze.
   virtual void cancel()=0;
   virtual void cancel(error_code_t& ec)=0;
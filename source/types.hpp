@@ -38,10 +38,13 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <map>
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <optional>
 #include <functional>
 #include <system_error>
 #include <openssl/conf.h>
 #include <openssl/ssl.h>
+#include "function.hpp"
 //============================================
 namespace ict { namespace asio {
 //============================================
@@ -49,12 +52,42 @@ namespace ict { namespace asio {
 typedef std::map<std::string,std::string> map_info_t;
 //! Kod błędu
 typedef std::error_code error_code_t;
-//! Ogólny handler
-typedef std::function<void(void)> asio_handler_t;
-//! Handler z obsługą błedu.
-typedef std::function<void(const error_code_t&)> error_handler_t;
+//! Ogólny handler (może być przenoszony, nie musi być kopiowalny).
+typedef unique_function<void(void)> asio_handler_t;
+//! Handler z obsługą błedu (może być przenoszony, nie musi być kopiowalny).
+typedef unique_function<void(const error_code_t&)> error_handler_t;
 //! Wskaźnik do kontekstu połączenia SSL
 typedef SSL_CTX * context_ptr;
+//! Priorytet (kolejka) zadań - patrz io_config_t::weights.
+enum priority_t {
+  high_priority, //!< Zadania pilne (np. kontrola stanu, sterowanie).
+  normal_priority, //!< Zadania zwykłe.
+  bulk_priority //!< Zadania masowe (np. przesyłanie dużych danych).
+};
+//! Opcje gniazda połączenia (nieustawione opcje nie są zmieniane) - patrz connection::interface::set_options().
+//! Opcje TCP są ignorowane dla gniazd lokalnych.
+struct socket_options_t {
+  //! TCP_NODELAY - wyłącza algorytm Nagle'a (małe zapisy są wysyłane natychmiast).
+  std::optional<bool> no_delay;
+  //! SO_SNDBUF - rozmiar bufora nadawczego (w bajtach).
+  std::optional<int> send_buffer;
+  //! SO_RCVBUF - rozmiar bufora odbiorczego (w bajtach).
+  std::optional<int> receive_buffer;
+  //! TCP_QUICKACK - natychmiastowe potwierdzenia (Uwaga: jądro może wyłączyć tę opcję - należy ją ponawiać w razie potrzeby).
+  std::optional<bool> quick_ack;
+  //! TCP_NOTSENT_LOWAT - maksymalna ilość niewysłanych danych w buforze nadawczym (w bajtach).
+  std::optional<int> not_sent_low_watermark;
+  //! SO_MAX_PACING_RATE - maksymalna prędkość wysyłania (w bajtach na sekundę).
+  std::optional<std::uint32_t> max_pacing_rate;
+  //! SO_KEEPALIVE - włącza sprawdzanie, czy połączenie jest aktywne.
+  std::optional<bool> keep_alive;
+  //! TCP_KEEPIDLE - czas bezczynności przed pierwszym sprawdzeniem (w sekundach).
+  std::optional<int> keep_alive_idle;
+  //! TCP_KEEPINTVL - odstęp pomiędzy kolejnymi sprawdzeniami (w sekundach).
+  std::optional<int> keep_alive_interval;
+  //! TCP_KEEPCNT - liczba nieudanych sprawdzeń, po której połączenie jest zamykane.
+  std::optional<int> keep_alive_count;
+};
 //============================================
 namespace message {
 //============================================